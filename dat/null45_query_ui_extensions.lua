@@ -12,3 +12,44 @@ null45_query_ui_extensions = {}
 -- The returned type will depend on the property type.
 -- Nil is returned if the property does not exist.
 null45_query_ui_extensions.get_property_value = function(property_id) return nil end
+
+-- Reads the specified property using its name, e.g. 'Bulldoze Cost'.
+-- See the Property Names section of the Query Variable List page for the supported names.
+-- The returned type will depend on the property type.
+-- Nil is returned if the name is unknown or the property does not exist.
+null45_query_ui_extensions.get_property_value_by_name = function(property_name) return nil end
+
+-- Reads the specified properties.
+-- The property_ids value must be an array of property id numbers, e.g. { hex2dec('00000020'), hex2dec('099afacd') }.
+-- Returns a table keyed by the property id, properties that do not exist are omitted from the table.
+-- This is faster than calling get_property_value for each property.
+-- Nil is returned if the parameter is not a table.
+null45_query_ui_extensions.get_property_values = function(property_ids) return nil end
+
+-- Returns a read-only view of the specified array property, the array elements are read
+-- directly from the building exemplar instead of being copied into a new table.
+-- Elements are accessed using a one-based index, e.g. view[1].
+-- Read the element count from view.n, the view is not a table so getn and the table library
+-- functions do not accept it.
+-- The view is only valid until the query dialog is closed, after that every element read returns nil.
+-- Nil is returned if the property does not exist or is not a numeric or boolean array.
+null45_query_ui_extensions.get_property_array_view = function(property_id) return nil end
+
+-- Returns a table that reads the occupant properties on first access, e.g. occupant[hex2dec('099afacd')]
+-- or occupant['Bulldoze Cost'], and keeps the converted value for the rest of the query dialog.
+-- The same table is returned for every call while the query dialog is open.
+-- See the Property Names section of the Query Variable List page for the supported property names.
+-- Nil is returned if there is no query dialog occupant.
+null45_query_ui_extensions.occupant = function() return nil end
+
+-- Returns a table with the live lot statistics, these are read once when the query dialog is opened.
+-- The table has the following fields:
+-- population: a table of the current occupant count, keyed by developer type,
+--             one of: r1, r2, r3, cs1, cs2, cs3, co2, co3, ir, id, im or iht.
+-- capacity: a table of the occupant capacity, keyed by developer type.
+-- jobs: an array of the lot job counts in low, medium and high wealth order.
+-- travel_jobs: an array of the lot trip capacities in low, medium and high wealth order.
+-- plopped: true if the lot is a plopped lot; otherwise, false.
+-- growth_stage: the growth stage of the lot, nil for plopped lots.
+-- Nil is returned if the occupant does not have a lot.
+null45_query_ui_extensions.get_lot_stats = function() return nil end
@@ -46,4 +46,373 @@ function null45_query_ui_extensions_test_get_garbage_pollution_at_center()
   end
   
   return garbage_value_string
-end
\ No newline at end of file
+end
+
+-- Demonstrates reading several properties with one call to
+-- null45_query_ui_extensions.get_property_values.
+function null45_query_ui_extensions_test_get_property_values()
+  local exemplar_name_id = hex2dec('00000020')
+  local bulldoze_cost_id = hex2dec('099afacd')
+  local values = null45_query_ui_extensions.get_property_values({ exemplar_name_id, bulldoze_cost_id })
+  
+  if values == nil then
+    return 'None'
+  end
+  
+  local exemplar_name = values[exemplar_name_id]
+  local bulldoze_cost = values[bulldoze_cost_id]
+  
+  if exemplar_name == nil then
+    exemplar_name = ''
+  end
+  
+  if bulldoze_cost == nil then
+    bulldoze_cost = 0
+  end
+  
+  return exemplar_name .. ', ' .. tostring(bulldoze_cost)
+end
+
+-- The property ids that are used by the benchmark functions below.
+-- Properties that the queried building does not have are still looked up, but are not counted.
+null45_query_ui_extensions_test_benchmark_property_ids =
+{
+  hex2dec('00000010'), -- Exemplar Type
+  hex2dec('00000020'), -- Exemplar Name
+  hex2dec('099afacd'), -- Bulldoze Cost
+  hex2dec('27812810'), -- Occupant Size
+  hex2dec('27812832'), -- Wealth
+  hex2dec('27812833'), -- Purpose
+  hex2dec('27812834'), -- Capacity Satisfied
+  hex2dec('27812837'), -- Budget Item: Purpose
+  hex2dec('27812838'), -- Budget Item: Line
+  hex2dec('27812839'), -- Budget Item: Cost
+  hex2dec('27812840'), -- Demand Satisfied
+  hex2dec('27812842'), -- Demand Satisfied (float)
+  hex2dec('27812851'), -- Pollution at Center
+  hex2dec('27812854'), -- Power Consumed
+  hex2dec('2a499f85'), -- Query Exemplar GUID
+  hex2dec('48f23a7e'), -- Water Source
+}
+
+-- The number of times that the benchmark functions read the property list.
+null45_query_ui_extensions_test_benchmark_iterations = 1000
+
+-- Reads the benchmark properties with one get_property_value call per property.
+function null45_query_ui_extensions_test_benchmark_single()
+  local property_ids = null45_query_ui_extensions_test_benchmark_property_ids
+  local count = 0
+  
+  for i = 1, null45_query_ui_extensions_test_benchmark_iterations do
+    for j = 1, getn(property_ids) do
+      if null45_query_ui_extensions.get_property_value(property_ids[j]) ~= nil then
+        count = count + 1
+      end
+    end
+  end
+  
+  return tostring(count) .. ' values read'
+end
+
+-- Reads the benchmark properties with one get_property_values call per iteration.
+function null45_query_ui_extensions_test_benchmark_batched()
+  local property_ids = null45_query_ui_extensions_test_benchmark_property_ids
+  local count = 0
+  
+  for i = 1, null45_query_ui_extensions_test_benchmark_iterations do
+    local values = null45_query_ui_extensions.get_property_values(property_ids)
+    
+    if values ~= nil then
+      for j = 1, getn(property_ids) do
+        if values[property_ids[j]] ~= nil then
+          count = count + 1
+        end
+      end
+    end
+  end
+  
+  return tostring(count) .. ' values read'
+end
+
+-- Demonstrates reading the garbage pollution value from the
+-- 'Pollution at Center' property array using an array view.
+function null45_query_ui_extensions_test_get_garbage_pollution_at_center_view()
+  local pollution_at_center = null45_query_ui_extensions.get_property_array_view(hex2dec('27812851'))
+  local garbage_value_string = 'None'
+  
+  if pollution_at_center ~= nil and pollution_at_center.n >= 3 then
+    garbage_value_string = tostring(pollution_at_center[3])
+  end
+  
+  return garbage_value_string
+end
+
+-- Demonstrates reading properties through the occupant proxy table.
+-- Repeated reads of the same property do not call back into the DLL.
+function null45_query_ui_extensions_test_occupant_proxy()
+  local occupant = null45_query_ui_extensions.occupant()
+  
+  if occupant == nil then
+    return 'None'
+  end
+  
+  local exemplar_name = occupant['Exemplar Name']
+  local bulldoze_cost = occupant[hex2dec('099afacd')]
+  
+  if exemplar_name == nil then
+    exemplar_name = ''
+  end
+  
+  if bulldoze_cost == nil then
+    bulldoze_cost = 0
+  end
+  
+  return exemplar_name .. ', ' .. tostring(bulldoze_cost)
+end
+
+-- Demonstrates getting the bulldoze cost property using its name.
+function null45_query_ui_extensions_test_get_bulldoze_cost_by_name()
+  local bulldoze_cost = null45_query_ui_extensions.get_property_value_by_name('Bulldoze Cost')
+  
+  if bulldoze_cost == nil then
+    bulldoze_cost = 0
+  end
+  
+  return tostring(bulldoze_cost)
+end
+
+-- Demonstrates building a custom summary from the lot statistics.
+function null45_query_ui_extensions_test_get_lot_stats()
+  local stats = null45_query_ui_extensions.get_lot_stats()
+  
+  if stats == nil then
+    return 'None'
+  end
+  
+  local residents = stats.population.r1 + stats.population.r2 + stats.population.r3
+  local jobs = stats.jobs[1] + stats.jobs[2] + stats.jobs[3]
+  local growth_stage = 'Plop'
+  
+  if stats.growth_stage ~= nil then
+    growth_stage = tostring(stats.growth_stage)
+  end
+  
+  return 'Residents: ' .. tostring(residents) .. ', Jobs: ' .. tostring(jobs) .. ', Stage: ' .. growth_stage
+end
+
+-- Returns true if the two property values are equal, array values are compared by element.
+function null45_query_ui_extensions_test_values_equal(a, b)
+  if type(a) ~= type(b) then
+    return false
+  end
+  
+  if type(a) == 'table' then
+    if getn(a) ~= getn(b) then
+      return false
+    end
+    
+    for i = 1, getn(a) do
+      if a[i] ~= b[i] then
+        return false
+      end
+    end
+    
+    return true
+  end
+  
+  return a == b
+end
+
+-- Checks that all of the property read functions return the same values.
+-- Returns 'ok' or a description of the first mismatch.
+function null45_query_ui_extensions_test_property_read_consistency()
+  local property_ids = null45_query_ui_extensions_test_benchmark_property_ids
+  local values = null45_query_ui_extensions.get_property_values(property_ids)
+  local occupant = null45_query_ui_extensions.occupant()
+  
+  if values == nil or occupant == nil then
+    return 'no occupant'
+  end
+  
+  for i = 1, getn(property_ids) do
+    local id = property_ids[i]
+    local single = null45_query_ui_extensions.get_property_value(id)
+    
+    if not null45_query_ui_extensions_test_values_equal(single, values[id]) then
+      return 'get_property_values mismatch for ' .. tostring(id)
+    end
+    
+    if not null45_query_ui_extensions_test_values_equal(single, occupant[id]) then
+      return 'occupant mismatch for ' .. tostring(id)
+    end
+    
+    if type(single) == 'table' then
+      local view = null45_query_ui_extensions.get_property_array_view(id)
+      
+      if view == nil or view.n ~= getn(single) then
+        return 'get_property_array_view count mismatch for ' .. tostring(id)
+      end
+      
+      for j = 1, view.n do
+        if view[j] ~= single[j] then
+          return 'get_property_array_view mismatch for ' .. tostring(id)
+        end
+      end
+    end
+  end
+  
+  if not null45_query_ui_extensions_test_values_equal(
+      null45_query_ui_extensions.get_property_value_by_name('Bulldoze Cost'),
+      null45_query_ui_extensions.get_property_value(hex2dec('099afacd'))) then
+    return 'get_property_value_by_name mismatch'
+  end
+  
+  return 'ok'
+end
+
+-- The property ids and names that are written to the test fixture, see null45_query_ui_extensions_test_record_fixture.
+-- Other Lua scripts can add the properties that their own test functions read using tinsert.
+null45_query_ui_extensions_test_fixture_property_ids = {}
+
+for i = 1, getn(null45_query_ui_extensions_test_benchmark_property_ids) do
+  tinsert(null45_query_ui_extensions_test_fixture_property_ids, null45_query_ui_extensions_test_benchmark_property_ids[i])
+end
+
+null45_query_ui_extensions_test_fixture_property_names = { 'Exemplar Name', 'Bulldoze Cost' }
+
+-- The developer type keys of the get_lot_stats population and capacity tables.
+null45_query_ui_extensions_test_fixture_developer_types = { 'r1', 'r2', 'r3', 'cs1', 'cs2', 'cs3', 'co2', 'co3', 'ir', 'id', 'im', 'iht' }
+
+-- Returns the Lua source of a string, number, boolean or array value.
+function null45_query_ui_extensions_test_fixture_value(value)
+  local value_type = type(value)
+  
+  if value_type == 'string' then
+    return string.format('%q', value)
+  elseif value_type == 'number' or value_type == 'boolean' then
+    return tostring(value)
+  elseif value_type == 'table' then
+    local text = '{ '
+    
+    for i = 1, getn(value) do
+      text = text .. null45_query_ui_extensions_test_fixture_value(value[i]) .. ', '
+    end
+    
+    return text .. '}'
+  end
+  
+  return 'nil'
+end
+
+-- Returns the Lua source of a table of values keyed by the developer type.
+function null45_query_ui_extensions_test_fixture_developer_table(values)
+  local developer_types = null45_query_ui_extensions_test_fixture_developer_types
+  local text = '{ '
+  
+  for i = 1, getn(developer_types) do
+    local key = developer_types[i]
+    text = text .. key .. ' = ' .. null45_query_ui_extensions_test_fixture_value(values[key]) .. ', '
+  end
+  
+  return text .. '}'
+end
+
+-- Records the properties and lot statistics of the query dialog occupant, and the results of the
+-- test functions, as a Lua script that the headless test runner in src/tests loads as a fixture.
+-- The debug test harness writes the returned string to SC4QueryUIHooks.LuaTestFixture.lua when
+-- RecordLuaTestFixture is enabled in SC4QueryUIHooks.ini.
+-- Array properties are recorded with all of their elements, so that get_property_array_view
+-- and the conversion of single element arrays can be reproduced.
+function null45_query_ui_extensions_test_record_fixture()
+  local property_ids = null45_query_ui_extensions_test_fixture_property_ids
+  local property_names = null45_query_ui_extensions_test_fixture_property_names
+  local test_functions = null45_query_ui_extensions_test_functions
+  local text = '-- Recorded by null45_query_ui_extensions_test_record_fixture.\nnull45_query_ui_extensions_fixture =\n{\n  properties =\n  {\n'
+  
+  for i = 1, getn(property_ids) do
+    local id = property_ids[i]
+    local value = null45_query_ui_extensions.get_property_value(id)
+    
+    if value ~= nil then
+      local view = null45_query_ui_extensions.get_property_array_view(id)
+      
+      if view ~= nil then
+        value = {}
+        
+        for j = 1, view.n do
+          value[j] = view[j]
+        end
+      end
+      
+      text = text .. string.format("    [hex2dec('%08x')] = ", id) .. null45_query_ui_extensions_test_fixture_value(value) .. ',\n'
+    end
+  end
+  
+  text = text .. '  },\n  properties_by_name =\n  {\n'
+  
+  for i = 1, getn(property_names) do
+    local name = property_names[i]
+    local value = null45_query_ui_extensions.get_property_value_by_name(name)
+    
+    if value ~= nil then
+      text = text .. '    [' .. string.format('%q', name) .. '] = ' .. null45_query_ui_extensions_test_fixture_value(value) .. ',\n'
+    end
+  end
+  
+  text = text .. '  },\n'
+  
+  local stats = null45_query_ui_extensions.get_lot_stats()
+  
+  if stats ~= nil then
+    text = text .. '  lot_stats =\n  {\n'
+    text = text .. '    population = ' .. null45_query_ui_extensions_test_fixture_developer_table(stats.population) .. ',\n'
+    text = text .. '    capacity = ' .. null45_query_ui_extensions_test_fixture_developer_table(stats.capacity) .. ',\n'
+    text = text .. '    jobs = ' .. null45_query_ui_extensions_test_fixture_value(stats.jobs) .. ',\n'
+    text = text .. '    travel_jobs = ' .. null45_query_ui_extensions_test_fixture_value(stats.travel_jobs) .. ',\n'
+    text = text .. '    plopped = ' .. tostring(stats.plopped) .. ',\n'
+    
+    if stats.growth_stage ~= nil then
+      text = text .. '    growth_stage = ' .. tostring(stats.growth_stage) .. ',\n'
+    end
+    
+    text = text .. '  },\n'
+  end
+  
+  text = text .. '  results =\n  {\n'
+  
+  for i = 1, getn(test_functions) do
+    local name = test_functions[i].name
+    local test_function = _G[name]
+    
+    if type(test_function) == 'function' then
+      local succeeded, result = pcall(test_function)
+      
+      if succeeded and type(result) == 'string' then
+        text = text .. '    [' .. string.format('%q', name) .. '] = ' .. string.format('%q', result) .. ',\n'
+      end
+    end
+  end
+  
+  return text .. '  },\n}\n'
+end
+
+-- The functions that the debug test harness runs when a query dialog is opened.
+-- name is the name of the test function.
+-- expected is optional, when it is set the harness reports whether the function returned that value.
+-- iterations is optional, it sets the number of calls that are used to measure the function latency.
+-- Other Lua scripts can add their own entries using tinsert.
+null45_query_ui_extensions_test_functions =
+{
+  { name = 'null45_query_ui_extensions_test_get_exemplar_name', iterations = 100 },
+  { name = 'null45_query_ui_extensions_test_get_bulldoze_cost', iterations = 100 },
+  { name = 'null45_query_ui_extensions_test_get_bulldoze_cost_by_name', iterations = 100 },
+  { name = 'null45_query_ui_extensions_test_get_garbage_pollution_at_center', iterations = 100 },
+  { name = 'null45_query_ui_extensions_test_get_garbage_pollution_at_center_view', iterations = 100 },
+  { name = 'null45_query_ui_extensions_test_get_property_values', iterations = 100 },
+  { name = 'null45_query_ui_extensions_test_occupant_proxy', iterations = 100 },
+  { name = 'null45_query_ui_extensions_test_get_lot_stats', iterations = 100 },
+  { name = 'null45_query_ui_extensions_test_property_read_consistency', expected = 'ok' },
+  -- The benchmark functions read the property list many times per call.
+  { name = 'null45_query_ui_extensions_test_benchmark_single' },
+  { name = 'null45_query_ui_extensions_test_benchmark_batched' },
+}
\ No newline at end of file
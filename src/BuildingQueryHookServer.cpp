@@ -25,6 +25,12 @@
 #include "cIQueryToolTipAppendTextHookTarget.h"
 #include "cRZBaseString.h"
 #include "GZStringUtil.h"
+#include "SubscriberStatistics.h"
+
+static constexpr const char* BeforeDialogHookName = "BuildingQueryHookServer before dialog hook";
+static constexpr const char* AfterDialogHookName = "BuildingQueryHookServer after dialog hook";
+static constexpr const char* CustomToolTipHookName = "BuildingQueryHookServer custom tool tip hook";
+static constexpr const char* AppendToolTipHookName = "BuildingQueryHookServer append tool tip hook";
 
 BuildingQueryHookServer::BuildingQueryHookServer()
 	: refCount(0)
@@ -33,7 +39,13 @@ BuildingQueryHookServer::BuildingQueryHookServer()
 
 bool BuildingQueryHookServer::QueryInterface(uint32_t riid, void** ppvObj)
 {
-	if (riid == GZIID_cIBuildingQueryHookServer)
+	if (riid == GZIID_cIBuildingQueryHookServer2)
+	{
+		*ppvObj = static_cast<cIBuildingQueryHookServer2*>(this);
+		AddRef();
+		return true;
+	}
+	else if (riid == GZIID_cIBuildingQueryHookServer)
 	{
 		*ppvObj = static_cast<cIBuildingQueryHookServer*>(this);
 		AddRef();
@@ -61,7 +73,12 @@ void BuildingQueryHookServer::SendBeforeQueryDialogNotifications(cISC4Occupant*
 
 			if (localTarget)
 			{
-				localTarget->BeforeDialogShown(pOccupant);
+				SubscriberStatistics::ScopedCall call(BeforeDialogHookName, localTarget);
+
+				if (!call.IsSkipped())
+				{
+					localTarget->BeforeDialogShown(pOccupant);
+				}
 			}
 		}
 	}
@@ -78,7 +95,14 @@ void BuildingQueryHookServer::SendAfterQueryDialogNotifications(cISC4Occupant* p
 
 			if (localTarget)
 			{
-				localTarget->AfterDialogShown(pOccupant);
+				// The after dialog hook is paired with the before dialog hook, a subscriber
+				// that received BeforeDialogShown always receives AfterDialogShown.
+				SubscriberStatistics::ScopedCall call(AfterDialogHookName, BeforeDialogHookName, localTarget);
+
+				if (!call.IsSkipped())
+				{
+					localTarget->AfterDialogShown(pOccupant);
+				}
 			}
 		}
 	}
@@ -109,7 +133,9 @@ bool BuildingQueryHookServer::SendCustomToolTipMessage(
 
 			if (localTarget)
 			{
-				if (localTarget->ProcessToolTip(
+				SubscriberStatistics::ScopedCall call(CustomToolTipHookName, localTarget);
+
+				if (!call.IsSkipped() && localTarget->ProcessToolTip(
 					occupant,
 					debugQuery,
 					title,
@@ -135,7 +161,7 @@ bool BuildingQueryHookServer::HasAppendToolTipSubscribers() const
 
 void BuildingQueryHookServer::SendAppendToolTipMessage(cISC4Occupant* const occupant, bool debugQuery, cIGZString& destination)
 {
-	size_t subscriberCount = customToolTipHookSubscribers.size();
+	size_t subscriberCount = appendToolTipHookSubscribers.size();
 	if (subscriberCount > 0)
 	{
 		for (cIQueryToolTipAppendTextHookTarget* pTarget : appendToolTipHookSubscribers)
@@ -144,9 +170,10 @@ void BuildingQueryHookServer::SendAppendToolTipMessage(cISC4Occupant* const occu
 
 			if (localTarget)
 			{
+				SubscriberStatistics::ScopedCall call(AppendToolTipHookName, localTarget);
 				cRZBaseString text;
 
-				if (localTarget->AppendQueryToolTipText(
+				if (!call.IsSkipped() && localTarget->AppendQueryToolTipText(
 					occupant,
 					debugQuery,
 					text))
@@ -181,72 +208,45 @@ uint32_t BuildingQueryHookServer::Release()
 
 bool BuildingQueryHookServer::AddNotification(cIBuildingQueryDialogHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = dialogHookSubscribers.emplace(target).second;
-	}
+	return AddNotification(target, QueryHookDefaultPriority);
+}
 
-	return result;
+bool BuildingQueryHookServer::AddNotification(cIBuildingQueryDialogHookTarget* target, int32_t priority)
+{
+	return dialogHookSubscribers.Add(target, priority);
 }
 
 bool BuildingQueryHookServer::RemoveNotification(cIBuildingQueryDialogHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = dialogHookSubscribers.erase(target) == 1;
-	}
-
-	return result;
+	return dialogHookSubscribers.Remove(target);
 }
 
 bool BuildingQueryHookServer::AddNotification(cIBuildingQueryCustomToolTipHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = customToolTipHookSubscribers.emplace(target).second;
-	}
+	return AddNotification(target, QueryHookDefaultPriority);
+}
 
-	return result;
+bool BuildingQueryHookServer::AddNotification(cIBuildingQueryCustomToolTipHookTarget* target, int32_t priority)
+{
+	return customToolTipHookSubscribers.Add(target, priority);
 }
 
 bool BuildingQueryHookServer::RemoveNotification(cIBuildingQueryCustomToolTipHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = customToolTipHookSubscribers.erase(target) == 1;
-	}
-
-	return result;
+	return customToolTipHookSubscribers.Remove(target);
 }
 
 bool BuildingQueryHookServer::AddNotification(cIQueryToolTipAppendTextHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = appendToolTipHookSubscribers.emplace(target).second;
-	}
+	return AddNotification(target, QueryHookDefaultPriority);
+}
 
-	return result;
+bool BuildingQueryHookServer::AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority)
+{
+	return appendToolTipHookSubscribers.Add(target, priority);
 }
 
 bool BuildingQueryHookServer::RemoveNotification(cIQueryToolTipAppendTextHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = appendToolTipHookSubscribers.erase(target) == 1;
-	}
-
-	return result;
+	return appendToolTipHookSubscribers.Remove(target);
 }
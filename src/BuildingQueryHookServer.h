@@ -20,13 +20,13 @@
  */
 
 #pragma once
-#include "cIBuildingQueryHookServer.h"
-#include <unordered_set>
+#include "cIBuildingQueryHookServer2.h"
+#include "PrioritizedSubscriberList.h"
 
 class cISC4Occupant;
 class cIGZString;
 
-class BuildingQueryHookServer final : public cIBuildingQueryHookServer
+class BuildingQueryHookServer final : public cIBuildingQueryHookServer2
 {
 public:
 	BuildingQueryHookServer();
@@ -76,18 +76,21 @@ public:
 	uint32_t Release() override;
 
 	bool AddNotification(cIBuildingQueryDialogHookTarget* target) override;
+	bool AddNotification(cIBuildingQueryDialogHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cIBuildingQueryDialogHookTarget* target) override;
 
 	bool AddNotification(cIBuildingQueryCustomToolTipHookTarget* target) override;
+	bool AddNotification(cIBuildingQueryCustomToolTipHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cIBuildingQueryCustomToolTipHookTarget* target) override;
 
 	bool AddNotification(cIQueryToolTipAppendTextHookTarget* target) override;
+	bool AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cIQueryToolTipAppendTextHookTarget* target) override;
 
 private:
 	uint32_t refCount;
-	std::unordered_set<cIBuildingQueryDialogHookTarget*> dialogHookSubscribers;
-	std::unordered_set<cIBuildingQueryCustomToolTipHookTarget*> customToolTipHookSubscribers;
-	std::unordered_set<cIQueryToolTipAppendTextHookTarget*> appendToolTipHookSubscribers;
+	PrioritizedSubscriberList<cIBuildingQueryDialogHookTarget> dialogHookSubscribers;
+	PrioritizedSubscriberList<cIBuildingQueryCustomToolTipHookTarget> customToolTipHookSubscribers;
+	PrioritizedSubscriberList<cIQueryToolTipAppendTextHookTarget> appendToolTipHookSubscribers;
 };
 
@@ -23,11 +23,13 @@
 #include "BuildingQueryHookServer.h"
 #include "DebugUtil.h"
 #include "GlobalHookServerPointers.h"
+#include "HookTrace.h"
 #include "Logger.h"
 #include "OccupantCopyHandler.h"
 #include "OccupantUtil.h"
 #include "Patcher.h"
 #include "QueryToolHelpers.h"
+#include "ToolTipCache.h"
 #include "cIGZString.h"
 #include "cISC4Occupant.h"
 
@@ -41,6 +43,8 @@ namespace
 
 	bool __cdecl HookedDoQueryDialog(cISC4Occupant* pOccupant)
 	{
+		HookTrace::Scope traceScope("HookedDoQueryDialog");
+
 #ifdef _DEBUG
 		cRZAutoRefCount<cIGZString> name;
 
@@ -78,7 +82,8 @@ namespace
 	static const pfnGetBuildingOccupantTipInfo RealGetBuildingOccupantTipInfo = reinterpret_cast<pfnGetBuildingOccupantTipInfo>(0x4D5E30);
 
 	bool SetCustomToolTip(
-		void* thisPtr,
+		cISC4Occupant* const pOccupant,
+		bool debugQueryEnabled,
 		cIGZString& title,
 		cIGZString& text,
 		uint32_t& backgroundImageIID,
@@ -89,9 +94,6 @@ namespace
 
 		if (spBuildingQueryHookServer && spBuildingQueryHookServer->HasCustomToolTipSubscribers())
 		{
-			const bool debugQueryEnabled = QueryToolHelpers::IsDebugQueryEnabled();
-			cISC4Occupant* const pOccupant = QueryToolHelpers::GetOccupant(thisPtr);
-
 			result = spBuildingQueryHookServer->SendCustomToolTipMessage(
 				pOccupant,
 				debugQueryEnabled,
@@ -105,13 +107,10 @@ namespace
 		return result;
 	}
 
-	void SetAppendedToolTipText(void* thisPtr, cIGZString& destination)
+	void SetAppendedToolTipText(cISC4Occupant* const pOccupant, bool debugQueryEnabled, cIGZString& destination)
 	{
 		if (spBuildingQueryHookServer && spBuildingQueryHookServer->HasAppendToolTipSubscribers())
 		{
-			const bool debugQueryEnabled = QueryToolHelpers::IsDebugQueryEnabled();
-			cISC4Occupant* const pOccupant = QueryToolHelpers::GetOccupant(thisPtr);
-
 			spBuildingQueryHookServer->SendAppendToolTipMessage(
 				pOccupant,
 				debugQueryEnabled,
@@ -132,10 +131,22 @@ namespace
 		uint32_t& meterImageIID,
 		float& meterPercentage)
 	{
-		if (!SetCustomToolTip(thisPtr, title, text, backgroundImageIID, meterImageIID, meterPercentage))
+		HookTrace::Scope traceScope("HookedGetBuildingOccupantTipInfo");
+
+		const bool debugQuery = QueryToolHelpers::IsDebugQueryEnabled();
+		cISC4Occupant* const pOccupant = QueryToolHelpers::GetOccupant(thisPtr);
+
+		ToolTipCache::ToolTipInfo info{ title, text, backgroundImageIID, meterImageIID, meterPercentage };
+
+		if (!ToolTipCache::TryGet(pOccupant, debugQuery, info))
 		{
-			RealGetBuildingOccupantTipInfo(thisPtr, title, text, backgroundImageIID, meterImageIID, meterPercentage);
-			SetAppendedToolTipText(thisPtr, text);
+			if (!SetCustomToolTip(pOccupant, debugQuery, title, text, backgroundImageIID, meterImageIID, meterPercentage))
+			{
+				RealGetBuildingOccupantTipInfo(thisPtr, title, text, backgroundImageIID, meterImageIID, meterPercentage);
+				SetAppendedToolTipText(pOccupant, debugQuery, text);
+			}
+
+			ToolTipCache::Add(pOccupant, debugQuery, info);
 		}
 	}
 
@@ -0,0 +1,196 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BuildingQueryVariableRegistry.h"
+#include "cIBuildingQueryVariableTarget.h"
+#include "cRZBaseString.h"
+
+namespace
+{
+	bool IsValidVariableName(std::string_view const& name)
+	{
+		return !name.empty()
+			&& name.find(':') == std::string_view::npos
+			&& name.find('#') == std::string_view::npos;
+	}
+}
+
+BuildingQueryVariableRegistry::BuildingQueryVariableRegistry()
+	: refCount(0)
+{
+}
+
+bool BuildingQueryVariableRegistry::HasRegisteredVariables() const
+{
+	return !namedVariables.empty() || !parameterizedVariables.empty();
+}
+
+bool BuildingQueryVariableRegistry::GetVariableValue(
+	cISC4Occupant* occupant,
+	std::string_view const& token,
+	cIGZString& destination) const
+{
+	cIBuildingQueryVariableTarget* pTarget = nullptr;
+	std::string_view name;
+	std::string_view parameters;
+
+	auto namedEntry = namedVariables.find(token);
+
+	if (namedEntry != namedVariables.end())
+	{
+		pTarget = namedEntry->second;
+		name = token;
+	}
+	else
+	{
+		// Parameterized variables are dispatched using the text before the first colon,
+		// so the lookup cost does not depend on the number of registered prefixes.
+		const size_t separatorIndex = token.find(':');
+
+		if (separatorIndex != std::string_view::npos)
+		{
+			name = token.substr(0, separatorIndex);
+
+			auto parameterizedEntry = parameterizedVariables.find(name);
+
+			if (parameterizedEntry != parameterizedVariables.end())
+			{
+				pTarget = parameterizedEntry->second;
+				parameters = token.substr(separatorIndex + 1);
+			}
+		}
+	}
+
+	if (!pTarget)
+	{
+		return false;
+	}
+
+	// The string may have been set to an error message by some other token callback method.
+	destination.Erase(0, destination.Strlen());
+
+	const cRZBaseString nameString(name.data(), static_cast<uint32_t>(name.size()));
+	const cRZBaseString parametersString(parameters.data(), static_cast<uint32_t>(parameters.size()));
+
+	if (!pTarget->GetVariableValue(occupant, nameString, parametersString, destination))
+	{
+		// Return an empty string if the handler method failed.
+		destination.Erase(0, destination.Strlen());
+	}
+
+	return true;
+}
+
+bool BuildingQueryVariableRegistry::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIBuildingQueryVariableRegistry)
+	{
+		*ppvObj = static_cast<cIBuildingQueryVariableRegistry*>(this);
+		AddRef();
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+		return true;
+	}
+
+	*ppvObj = nullptr;
+	return false;
+}
+
+uint32_t BuildingQueryVariableRegistry::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t BuildingQueryVariableRegistry::Release()
+{
+	// Note that because this class is a singleton, it does not delete itself when
+	// the reference count drops to zero.
+	//
+	// QueryUIHooksDllDirector will hand out references to the singleton when
+	// GZCOM requests an instance of the cIBuildingQueryVariableRegistry interface.
+
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool BuildingQueryVariableRegistry::RegisterVariable(const char* name, cIBuildingQueryVariableTarget* target)
+{
+	return Register(namedVariables, name, target);
+}
+
+bool BuildingQueryVariableRegistry::UnregisterVariable(const char* name, cIBuildingQueryVariableTarget* target)
+{
+	return Unregister(namedVariables, name, target);
+}
+
+bool BuildingQueryVariableRegistry::RegisterParameterizedVariable(const char* prefix, cIBuildingQueryVariableTarget* target)
+{
+	return Register(parameterizedVariables, prefix, target);
+}
+
+bool BuildingQueryVariableRegistry::UnregisterParameterizedVariable(const char* prefix, cIBuildingQueryVariableTarget* target)
+{
+	return Unregister(parameterizedVariables, prefix, target);
+}
+
+bool BuildingQueryVariableRegistry::Register(VariableMap& map, const char* name, cIBuildingQueryVariableTarget* target)
+{
+	bool result = false;
+
+	if (name && target)
+	{
+		const std::string_view nameAsStringView(name);
+
+		if (IsValidVariableName(nameAsStringView))
+		{
+			result = map.emplace(std::string(nameAsStringView), target).second;
+		}
+	}
+
+	return result;
+}
+
+bool BuildingQueryVariableRegistry::Unregister(VariableMap& map, const char* name, cIBuildingQueryVariableTarget* target)
+{
+	bool result = false;
+
+	if (name && target)
+	{
+		auto it = map.find(std::string_view(name));
+
+		// Only the target that registered the variable is allowed to remove it.
+		if (it != map.end() && it->second == target)
+		{
+			map.erase(it);
+			result = true;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cIBuildingQueryVariableRegistry.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+class cIBuildingQueryVariableTarget;
+class cIGZString;
+class cISC4Occupant;
+
+class BuildingQueryVariableRegistry final : public cIBuildingQueryVariableRegistry
+{
+public:
+	BuildingQueryVariableRegistry();
+
+	bool HasRegisteredVariables() const;
+
+	/**
+	 * @brief Gets the value of a registered variable.
+	 * @param occupant The occupant that is being queried.
+	 * @param token The token text, without the surrounding # characters.
+	 * @param destination The string that receives the variable value.
+	 * @return true if the token belongs to a registered variable; otherwise, false.
+	 */
+	bool GetVariableValue(cISC4Occupant* occupant, std::string_view const& token, cIGZString& destination) const;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool RegisterVariable(const char* name, cIBuildingQueryVariableTarget* target) override;
+	bool UnregisterVariable(const char* name, cIBuildingQueryVariableTarget* target) override;
+
+	bool RegisterParameterizedVariable(const char* prefix, cIBuildingQueryVariableTarget* target) override;
+	bool UnregisterParameterizedVariable(const char* prefix, cIBuildingQueryVariableTarget* target) override;
+
+private:
+	struct TransparentStringHash
+	{
+		using is_transparent = void;
+
+		size_t operator()(std::string_view const& value) const noexcept
+		{
+			return std::hash<std::string_view>{}(value);
+		}
+	};
+
+	typedef std::unordered_map<std::string, cIBuildingQueryVariableTarget*, TransparentStringHash, std::equal_to<>> VariableMap;
+
+	static bool Register(VariableMap& map, const char* name, cIBuildingQueryVariableTarget* target);
+	static bool Unregister(VariableMap& map, const char* name, cIBuildingQueryVariableTarget* target);
+
+	uint32_t refCount;
+	VariableMap namedVariables;
+	VariableMap parameterizedVariables;
+};
@@ -27,6 +27,9 @@
 using namespace std::string_view_literals;
 
 static constexpr std::string_view PluginConfigFileName = "SC4QueryUIHooks.ini"sv;
+static constexpr std::string_view HookTraceFileName = "SC4QueryUIHooks.trace.json"sv;
+static constexpr std::string_view LuaTestFixtureFileName = "SC4QueryUIHooks.LuaTestFixture.lua"sv;
+static constexpr std::string_view SimGridExportFileName = "SC4QueryUIHooks.SimGrids.bin"sv;
 
 namespace
 {
@@ -54,3 +57,27 @@ std::filesystem::path FileSystem::GetConfigFilePath()
 
 	return path;
 }
+
+std::filesystem::path FileSystem::GetHookTraceFilePath()
+{
+	std::filesystem::path path = GetDllFolderPath();
+	path /= HookTraceFileName;
+
+	return path;
+}
+
+std::filesystem::path FileSystem::GetLuaTestFixtureFilePath()
+{
+	std::filesystem::path path = GetDllFolderPath();
+	path /= LuaTestFixtureFileName;
+
+	return path;
+}
+
+std::filesystem::path FileSystem::GetSimGridExportFilePath()
+{
+	std::filesystem::path path = GetDllFolderPath();
+	path /= SimGridExportFileName;
+
+	return path;
+}
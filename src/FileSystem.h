@@ -25,4 +25,10 @@
 namespace FileSystem
 {
 	std::filesystem::path GetConfigFilePath();
+
+	std::filesystem::path GetHookTraceFilePath();
+
+	std::filesystem::path GetLuaTestFixtureFilePath();
+
+	std::filesystem::path GetSimGridExportFilePath();
 }
\ No newline at end of file
@@ -23,9 +23,11 @@
 #include "cIGZString.h"
 #include "FloraQueryToolTipHookServer.h"
 #include "GlobalHookServerPointers.h"
+#include "HookTrace.h"
 #include "OccupantUtil.h"
 #include "Patcher.h"
 #include "QueryToolHelpers.h"
+#include "ToolTipCache.h"
 
 namespace
 {
@@ -70,13 +72,20 @@ namespace
 		cIGZString& title,
 		cIGZString& text)
 	{
+		HookTrace::Scope traceScope("HookedGetFloraOccupantTipInfo");
+
 		const bool debugQuery = QueryToolHelpers::IsDebugQueryEnabled();
 		cISC4Occupant* const pOccupant = QueryToolHelpers::GetOccupant(thisPtr);
 
-		if (!SetCustomToolTip(pOccupant, debugQuery, title, text))
+		if (!ToolTipCache::TryGet(pOccupant, debugQuery, title, text))
 		{
-			OccupantUtil::GetDisplayName(pOccupant, title);
-			SetAppendedToolTipText(pOccupant, debugQuery, text);
+			if (!SetCustomToolTip(pOccupant, debugQuery, title, text))
+			{
+				OccupantUtil::GetDisplayName(pOccupant, title);
+				SetAppendedToolTipText(pOccupant, debugQuery, text);
+			}
+
+			ToolTipCache::Add(pOccupant, debugQuery, title, text);
 		}
 	}
 }
@@ -24,6 +24,10 @@
 #include "cIQueryToolTipAppendTextHookTarget.h"
 #include "cRZBaseString.h"
 #include "GZStringUtil.h"
+#include "SubscriberStatistics.h"
+
+static constexpr const char* CustomToolTipHookName = "FloraQueryToolTipHookServer custom tool tip hook";
+static constexpr const char* AppendToolTipHookName = "FloraQueryToolTipHookServer append tool tip hook";
 
 FloraQueryToolTipHookServer::FloraQueryToolTipHookServer()
 	: refCount(0)
@@ -32,7 +36,13 @@ FloraQueryToolTipHookServer::FloraQueryToolTipHookServer()
 
 bool FloraQueryToolTipHookServer::QueryInterface(uint32_t riid, void** ppvObj)
 {
-	if (riid == GZIID_cIFloraQueryToolTipHookServer)
+	if (riid == GZIID_cIFloraQueryToolTipHookServer2)
+	{
+		*ppvObj = static_cast<cIFloraQueryToolTipHookServer2*>(this);
+		AddRef();
+		return true;
+	}
+	else if (riid == GZIID_cIFloraQueryToolTipHookServer)
 	{
 		*ppvObj = static_cast<cIFloraQueryToolTipHookServer*>(this);
 		AddRef();
@@ -86,7 +96,9 @@ bool FloraQueryToolTipHookServer::SendCustomToolTipMessage(
 
 			if (localTarget)
 			{
-				if (localTarget->ProcessToolTip(
+				SubscriberStatistics::ScopedCall call(CustomToolTipHookName, localTarget);
+
+				if (!call.IsSkipped() && localTarget->ProcessToolTip(
 					occupant,
 					debugQuery,
 					title,
@@ -109,7 +121,7 @@ bool FloraQueryToolTipHookServer::HasAppendToolTipSubscribers() const
 
 void FloraQueryToolTipHookServer::SendAppendToolTipMessage(cISC4Occupant* const occupant, bool debugQuery, cIGZString& destination)
 {
-	size_t subscriberCount = customToolTipHookSubscribers.size();
+	size_t subscriberCount = appendToolTipHookSubscribers.size();
 	if (subscriberCount > 0)
 	{
 		for (cIQueryToolTipAppendTextHookTarget* pTarget : appendToolTipHookSubscribers)
@@ -118,9 +130,10 @@ void FloraQueryToolTipHookServer::SendAppendToolTipMessage(cISC4Occupant* const
 
 			if (localTarget)
 			{
+				SubscriberStatistics::ScopedCall call(AppendToolTipHookName, localTarget);
 				cRZBaseString text;
 
-				if (localTarget->AppendQueryToolTipText(
+				if (!call.IsSkipped() && localTarget->AppendQueryToolTipText(
 					occupant,
 					debugQuery,
 					text))
@@ -134,48 +147,30 @@ void FloraQueryToolTipHookServer::SendAppendToolTipMessage(cISC4Occupant* const
 
 bool FloraQueryToolTipHookServer::AddNotification(cIFloraQueryCustomToolTipHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = customToolTipHookSubscribers.emplace(target).second;
-	}
+	return AddNotification(target, QueryHookDefaultPriority);
+}
 
-	return result;
+bool FloraQueryToolTipHookServer::AddNotification(cIFloraQueryCustomToolTipHookTarget* target, int32_t priority)
+{
+	return customToolTipHookSubscribers.Add(target, priority);
 }
 
 bool FloraQueryToolTipHookServer::RemoveNotification(cIFloraQueryCustomToolTipHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = customToolTipHookSubscribers.erase(target) == 1;
-	}
-
-	return result;
+	return customToolTipHookSubscribers.Remove(target);
 }
 
 bool FloraQueryToolTipHookServer::AddNotification(cIQueryToolTipAppendTextHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = appendToolTipHookSubscribers.emplace(target).second;
-	}
+	return AddNotification(target, QueryHookDefaultPriority);
+}
 
-	return result;
+bool FloraQueryToolTipHookServer::AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority)
+{
+	return appendToolTipHookSubscribers.Add(target, priority);
 }
 
 bool FloraQueryToolTipHookServer::RemoveNotification(cIQueryToolTipAppendTextHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = appendToolTipHookSubscribers.erase(target) == 1;
-	}
-
-	return result;
+	return appendToolTipHookSubscribers.Remove(target);
 }
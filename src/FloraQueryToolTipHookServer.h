@@ -20,13 +20,13 @@
  */
 
 #pragma once
-#include "cIFloraQueryToolTipHookServer.h"
-#include <unordered_set>
+#include "cIFloraQueryToolTipHookServer2.h"
+#include "PrioritizedSubscriberList.h"
 
 class cISC4Occupant;
 class cIGZString;
 
-class FloraQueryToolTipHookServer : public cIFloraQueryToolTipHookServer
+class FloraQueryToolTipHookServer : public cIFloraQueryToolTipHookServer2
 {
 public:
 	FloraQueryToolTipHookServer();
@@ -66,14 +66,16 @@ public:
 		cIGZString& destination);
 
 	bool AddNotification(cIFloraQueryCustomToolTipHookTarget* target) override;
+	bool AddNotification(cIFloraQueryCustomToolTipHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cIFloraQueryCustomToolTipHookTarget* target) override;
 
 	bool AddNotification(cIQueryToolTipAppendTextHookTarget* target) override;
+	bool AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cIQueryToolTipAppendTextHookTarget* target) override;
 
 private:
 	uint32_t refCount;
-	std::unordered_set<cIFloraQueryCustomToolTipHookTarget*> customToolTipHookSubscribers;
-	std::unordered_set<cIQueryToolTipAppendTextHookTarget*> appendToolTipHookSubscribers;
+	PrioritizedSubscriberList<cIFloraQueryCustomToolTipHookTarget> customToolTipHookSubscribers;
+	PrioritizedSubscriberList<cIQueryToolTipAppendTextHookTarget> appendToolTipHookSubscribers;
 };
 
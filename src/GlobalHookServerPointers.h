@@ -22,11 +22,15 @@
 #pragma once
 
 class BuildingQueryHookServer;
+class BuildingQueryVariableRegistry;
 class FloraQueryToolTipHookServer;
 class NetworkQueryToolTipHookServer;
 class PropQueryToolTipHookServer;
+class TerrainQueryToolTipHookServer;
 
 extern BuildingQueryHookServer* spBuildingQueryHookServer;
+extern BuildingQueryVariableRegistry* spBuildingQueryVariableRegistry;
 extern FloraQueryToolTipHookServer* spFloraQueryToolTipHookServer;
 extern NetworkQueryToolTipHookServer* spNetworkQueryToolTipHookServer;
-extern PropQueryToolTipHookServer* spPropQueryToolTipHookServer;
\ No newline at end of file
+extern PropQueryToolTipHookServer* spPropQueryToolTipHookServer;
+extern TerrainQueryToolTipHookServer* spTerrainQueryToolTipHookServer;
\ No newline at end of file
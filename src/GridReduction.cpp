@@ -0,0 +1,191 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridReduction.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRID_REDUCTION_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+#ifdef GRID_REDUCTION_USE_SSE2
+	// SSE2 does not have 32-bit integer min/max instructions, they were added in SSE4.1.
+	inline __m128i Min32(__m128i a, __m128i b)
+	{
+		const __m128i greater = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+	}
+
+	inline __m128i Max32(__m128i a, __m128i b)
+	{
+		const __m128i greater = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+	}
+
+	// Sign extends the four 32-bit lanes to 64 bits and adds them to the two 64-bit accumulators.
+	inline __m128i AddWidened(__m128i sum, __m128i value)
+	{
+		const __m128i sign = _mm_srai_epi32(value, 31);
+
+		sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(value, sign));
+		return _mm_add_epi64(sum, _mm_unpackhi_epi32(value, sign));
+	}
+
+	inline int32_t HorizontalMin(__m128i value)
+	{
+		value = Min32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+		value = Min32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(value);
+	}
+
+	inline int32_t HorizontalMax(__m128i value)
+	{
+		value = Max32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+		value = Max32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(value);
+	}
+
+	inline int64_t HorizontalSum64(__m128i value)
+	{
+		alignas(16) int64_t lanes[2];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), value);
+
+		return lanes[0] + lanes[1];
+	}
+#endif // GRID_REDUCTION_USE_SSE2
+
+	int32_t GetPercentile(int32_t* values, size_t count, size_t percentile)
+	{
+		// Nearest-rank percentile.
+		const size_t rank = std::max<size_t>(1, (count * percentile + 99) / 100);
+		int32_t* const nth = values + (rank - 1);
+
+		std::nth_element(values, nth, values + count);
+		return *nth;
+	}
+}
+
+void GridReduction::MinMaxSumScalar(
+	const int32_t* values,
+	size_t count,
+	int32_t& minimum,
+	int32_t& maximum,
+	int64_t& sum)
+{
+	int32_t localMinimum = values[0];
+	int32_t localMaximum = values[0];
+	int64_t localSum = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const int32_t value = values[i];
+
+		localMinimum = std::min(localMinimum, value);
+		localMaximum = std::max(localMaximum, value);
+		localSum += value;
+	}
+
+	minimum = localMinimum;
+	maximum = localMaximum;
+	sum = localSum;
+}
+
+void GridReduction::MinMaxSum(
+	const int32_t* values,
+	size_t count,
+	int32_t& minimum,
+	int32_t& maximum,
+	int64_t& sum)
+{
+#ifdef GRID_REDUCTION_USE_SSE2
+	if (count >= 8)
+	{
+		// Two independent accumulator sets hide the latency of the compare and add chains.
+		__m128i minimum0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+		__m128i minimum1 = minimum0;
+		__m128i maximum0 = minimum0;
+		__m128i maximum1 = minimum0;
+		__m128i sum0 = _mm_setzero_si128();
+		__m128i sum1 = _mm_setzero_si128();
+
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m128i value0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+			const __m128i value1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 4));
+
+			minimum0 = Min32(minimum0, value0);
+			minimum1 = Min32(minimum1, value1);
+			maximum0 = Max32(maximum0, value0);
+			maximum1 = Max32(maximum1, value1);
+			sum0 = AddWidened(sum0, value0);
+			sum1 = AddWidened(sum1, value1);
+		}
+
+		int32_t localMinimum = HorizontalMin(Min32(minimum0, minimum1));
+		int32_t localMaximum = HorizontalMax(Max32(maximum0, maximum1));
+		int64_t localSum = HorizontalSum64(_mm_add_epi64(sum0, sum1));
+
+		if (i < count)
+		{
+			int32_t tailMinimum = 0;
+			int32_t tailMaximum = 0;
+			int64_t tailSum = 0;
+
+			MinMaxSumScalar(values + i, count - i, tailMinimum, tailMaximum, tailSum);
+
+			localMinimum = std::min(localMinimum, tailMinimum);
+			localMaximum = std::max(localMaximum, tailMaximum);
+			localSum += tailSum;
+		}
+
+		minimum = localMinimum;
+		maximum = localMaximum;
+		sum = localSum;
+		return;
+	}
+#endif // GRID_REDUCTION_USE_SSE2
+
+	MinMaxSumScalar(values, count, minimum, maximum, sum);
+}
+
+GridStatistics GridReduction::Compute(int32_t* values, size_t count)
+{
+	GridStatistics statistics{};
+
+	if (count > 0)
+	{
+		int64_t sum = 0;
+
+		MinMaxSum(values, count, statistics.minimum, statistics.maximum, sum);
+
+		statistics.count = count;
+		statistics.mean = static_cast<double>(sum) / static_cast<double>(count);
+		statistics.median = GetPercentile(values, count, 50);
+		statistics.percentile90 = GetPercentile(values, count, 90);
+	}
+
+	return statistics;
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Summary statistics of a set of sim grid cell values.
+struct GridStatistics
+{
+	size_t count;
+	int32_t minimum;
+	int32_t maximum;
+	double mean;
+	int32_t median;
+	int32_t percentile90;
+};
+
+// Reduction kernels for sim grid cell values that were copied into a contiguous buffer.
+// The kernels use SSE2 when the compiler targets it and a scalar loop otherwise, they do not
+// depend on the game so they can be built and compared against each other on any platform.
+namespace GridReduction
+{
+	/**
+	 * @brief Computes the minimum, maximum and sum of the values using the vectorized kernel.
+	 * @param values The values.
+	 * @param count The number of values, must be greater than 0.
+	 * @param minimum Receives the minimum value.
+	 * @param maximum Receives the maximum value.
+	 * @param sum Receives the sum of the values.
+	 */
+	void MinMaxSum(const int32_t* values, size_t count, int32_t& minimum, int32_t& maximum, int64_t& sum);
+
+	/**
+	 * @brief The scalar reference implementation of MinMaxSum.
+	 */
+	void MinMaxSumScalar(const int32_t* values, size_t count, int32_t& minimum, int32_t& maximum, int64_t& sum);
+
+	/**
+	 * @brief Computes the statistics of the values.
+	 * @param values The values, they are reordered when the percentiles are computed.
+	 * @param count The number of values.
+	 * @return The statistics, all fields are 0 if count is 0.
+	 */
+	GridStatistics Compute(int32_t* values, size_t count);
+}
@@ -0,0 +1,290 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HookTrace.h"
+#include "SingleProducerRingBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	enum class TraceEventPhase : uint8_t
+	{
+		Begin,
+		End,
+	};
+
+	struct TraceEvent
+	{
+		const char* name;
+		// The subscriber module and interface pointer, only set for subscriber calls.
+		const char* moduleName;
+		const void* subscriber;
+		uint64_t timestamp;
+		TraceEventPhase phase;
+	};
+
+	void WriteJsonString(std::ostream& stream, const char* value)
+	{
+		stream << '"';
+
+		for (const char* p = value; *p != '\0'; p++)
+		{
+			const unsigned char c = static_cast<unsigned char>(*p);
+
+			if (c == '"' || c == '\\')
+			{
+				stream << '\\' << static_cast<char>(c);
+			}
+			else if (c < 0x20)
+			{
+				static constexpr char HexDigits[] = "0123456789abcdef";
+
+				stream << "\\u00" << HexDigits[c >> 4] << HexDigits[c & 0xf];
+			}
+			else
+			{
+				stream << static_cast<char>(c);
+			}
+		}
+
+		stream << '"';
+	}
+
+	// The buffer holds about 1 second of events when the hooks are called continuously,
+	// the writer thread empties it more often than that.
+	static constexpr size_t TraceBufferCapacity = 16384;
+	static constexpr std::chrono::milliseconds WriterInterval(50);
+
+	using TraceEventBuffer = SingleProducerRingBuffer<TraceEvent, TraceBufferCapacity>;
+
+	class TraceWriter
+	{
+	public:
+		TraceWriter()
+			: buffer(),
+			  file(),
+			  thread(),
+			  mutex(),
+			  stopCondition(),
+			  stopRequested(false),
+			  firstEvent(true),
+			  droppedEvents(0)
+		{
+		}
+
+		bool Open(const std::filesystem::path& path)
+		{
+			file.open(path, std::ofstream::out | std::ofstream::trunc);
+
+			if (!file)
+			{
+				return false;
+			}
+
+			file << "{\"traceEvents\":[";
+			thread = std::thread(&TraceWriter::Run, this);
+			return true;
+		}
+
+		void Close()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopRequested = true;
+			}
+			stopCondition.notify_one();
+
+			if (thread.joinable())
+			{
+				thread.join();
+			}
+
+			WriteEvents();
+
+			file << "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":"
+				 << droppedEvents.load(std::memory_order_relaxed)
+				 << "}}";
+			file.close();
+		}
+
+		void Add(const TraceEvent& event)
+		{
+			if (!buffer.TryPush(event))
+			{
+				droppedEvents.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		void Run()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (!stopRequested)
+			{
+				stopCondition.wait_for(lock, WriterInterval);
+
+				lock.unlock();
+				WriteEvents();
+				lock.lock();
+			}
+		}
+
+		void WriteEvents()
+		{
+			TraceEvent event{};
+
+			while (buffer.TryPop(event))
+			{
+				if (!firstEvent)
+				{
+					file << ',';
+				}
+				firstEvent = false;
+
+				// The timestamps are in nanoseconds, Chrome expects microseconds.
+				file << "\n{\"name\":";
+				WriteJsonString(file, event.name);
+				file << ",\"ph\":\"" << (event.phase == TraceEventPhase::Begin ? 'B' : 'E')
+					 << "\",\"ts\":" << (event.timestamp / 1000) << '.';
+
+				const uint32_t fraction = static_cast<uint32_t>(event.timestamp % 1000);
+
+				file << static_cast<char>('0' + fraction / 100)
+					 << static_cast<char>('0' + (fraction / 10) % 10)
+					 << static_cast<char>('0' + fraction % 10)
+					 << ",\"pid\":1,\"tid\":1";
+
+				if (event.moduleName)
+				{
+					// The subscriber is identified by its module and interface pointer,
+					// trace viewers show the arguments of the selected event.
+					char subscriberText[2 + 16 + 1]{};
+					std::snprintf(
+						subscriberText,
+						sizeof(subscriberText),
+						"0x%llx",
+						static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(event.subscriber)));
+
+					file << ",\"args\":{\"module\":";
+					WriteJsonString(file, event.moduleName);
+					file << ",\"subscriber\":\"" << subscriberText << "\"}";
+				}
+
+				file << '}';
+			}
+
+			file.flush();
+		}
+
+		TraceEventBuffer buffer;
+		std::ofstream file;
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable stopCondition;
+		bool stopRequested;
+		bool firstEvent;
+		std::atomic<uint64_t> droppedEvents;
+	};
+
+	std::unique_ptr<TraceWriter> spWriter;
+	std::atomic<bool> sEnabled(false);
+	std::thread::id sProducerThread;
+	std::chrono::steady_clock::time_point sStartTime;
+
+	void AddEvent(const char* name, const char* moduleName, const void* subscriber, TraceEventPhase phase)
+	{
+		if (sEnabled.load(std::memory_order_acquire) && std::this_thread::get_id() == sProducerThread)
+		{
+			const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - sStartTime);
+
+			spWriter->Add(TraceEvent{ name, moduleName, subscriber, static_cast<uint64_t>(timestamp.count()), phase });
+		}
+	}
+}
+
+bool HookTrace::Start(const std::filesystem::path& path)
+{
+	if (spWriter)
+	{
+		return false;
+	}
+
+	std::unique_ptr<TraceWriter> writer = std::make_unique<TraceWriter>();
+
+	if (!writer->Open(path))
+	{
+		return false;
+	}
+
+	spWriter = std::move(writer);
+	sProducerThread = std::this_thread::get_id();
+	sStartTime = std::chrono::steady_clock::now();
+	sEnabled.store(true, std::memory_order_release);
+	return true;
+}
+
+void HookTrace::Stop()
+{
+	if (spWriter)
+	{
+		sEnabled.store(false, std::memory_order_release);
+
+		spWriter->Close();
+		spWriter.reset();
+	}
+}
+
+void HookTrace::Begin(const char* name)
+{
+	AddEvent(name, nullptr, nullptr, TraceEventPhase::Begin);
+}
+
+void HookTrace::BeginSubscriberCall(const char* name, const char* moduleName, const void* pSubscriber)
+{
+	AddEvent(name, moduleName, pSubscriber, TraceEventPhase::Begin);
+}
+
+void HookTrace::End(const char* name)
+{
+	AddEvent(name, nullptr, nullptr, TraceEventPhase::End);
+}
+
+HookTrace::Scope::Scope(const char* name)
+	: name(name)
+{
+	Begin(name);
+}
+
+HookTrace::Scope::~Scope()
+{
+	End(name);
+}
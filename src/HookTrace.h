@@ -0,0 +1,80 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <filesystem>
+
+// Records the begin and end time of the query hooks and their subscriber calls,
+// and writes them to a Chrome trace event JSON file that can be opened in a
+// trace viewer such as chrome://tracing or Perfetto.
+//
+// The events are recorded in a lock-free buffer on the thread that started the
+// trace, and a background thread writes them to the file. Events from other
+// threads and events that do not fit in the buffer are discarded.
+namespace HookTrace
+{
+	/**
+	 * @brief Starts the trace and the background writer thread.
+	 * @param path The path of the trace file, it is overwritten if it exists.
+	 * @return true if the trace was started; otherwise, false.
+	 */
+	bool Start(const std::filesystem::path& path);
+
+	/**
+	 * @brief Stops the trace, writes the remaining events and closes the file.
+	 * Must be called on the thread that started the trace.
+	 */
+	void Stop();
+
+	/**
+	 * @brief Records the start of a traced event.
+	 * @param name The event name. Must be a string literal.
+	 */
+	void Begin(const char* name);
+
+	/**
+	 * @brief Records the start of a hook subscriber call.
+	 * @param name The event name. Must be a string literal.
+	 * @param moduleName The file name of the module that contains the subscriber.
+	 * Must remain valid for the lifetime of the process.
+	 * @param pSubscriber The subscriber interface pointer.
+	 */
+	void BeginSubscriberCall(const char* name, const char* moduleName, const void* pSubscriber);
+
+	/**
+	 * @brief Records the end of a traced event.
+	 * @param name The event name. Must be a string literal.
+	 */
+	void End(const char* name);
+
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* name;
+	};
+}
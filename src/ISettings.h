@@ -20,6 +20,7 @@
  */
 
 #pragma once
+#include <cstdint>
 
 class ISettings
 {
@@ -27,4 +28,14 @@ public:
 	virtual bool EnableOccupantQuerySounds() const = 0;
 
 	virtual bool LogBuildingPluginPath() const = 0;
+
+	virtual uint32_t SubscriberTimeBudgetMilliseconds() const = 0;
+
+	virtual bool EnableHookTrace() const = 0;
+
+	virtual uint32_t TerrainQueryAggregateRadius() const = 0;
+
+	virtual bool RecordLuaTestFixture() const = 0;
+
+	virtual bool BenchmarkDetokenizerRegistration() const = 0;
 };
\ No newline at end of file
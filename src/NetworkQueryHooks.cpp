@@ -22,9 +22,11 @@
 #include "NetworkQueryHooks.h"
 #include "NetworkQueryToolTipHookServer.h"
 #include "GlobalHookServerPointers.h"
+#include "HookTrace.h"
 #include "DebugUtil.h"
 #include "Patcher.h"
 #include "QueryToolHelpers.h"
+#include "ToolTipCache.h"
 #include "cIGZString.h"
 #include <Windows.h>
 
@@ -38,7 +40,8 @@ namespace
 	static const pfnGetNetworkOccupantTipInfo RealGetNetworkOccupantTipInfo = reinterpret_cast<pfnGetNetworkOccupantTipInfo>(0x4CF8A0);
 
 	bool SetCustomToolTip(
-		void* thisPtr,
+		cISC4Occupant* const pOccupant,
+		bool debugQueryEnabled,
 		cIGZString& title,
 		cIGZString& text)
 	{
@@ -46,9 +49,6 @@ namespace
 
 		if (spNetworkQueryToolTipHookServer && spNetworkQueryToolTipHookServer->HasCustomToolTipSubscribers())
 		{
-			const bool debugQueryEnabled = QueryToolHelpers::IsDebugQueryEnabled();
-			cISC4Occupant* const pOccupant = QueryToolHelpers::GetOccupant(thisPtr);
-
 			if (spNetworkQueryToolTipHookServer->SendCustomToolTipMessage(pOccupant, debugQueryEnabled, title, text))
 			{
 				handled = true;
@@ -58,13 +58,10 @@ namespace
 		return handled;
 	}
 
-	void SetAppendedToolTipText(void* thisPtr, cIGZString& destination)
+	void SetAppendedToolTipText(cISC4Occupant* const pOccupant, bool debugQueryEnabled, cIGZString& destination)
 	{
 		if (spNetworkQueryToolTipHookServer && spNetworkQueryToolTipHookServer->HasAppendToolTipSubscribers())
 		{
-			const bool debugQueryEnabled = QueryToolHelpers::IsDebugQueryEnabled();
-			cISC4Occupant* const pOccupant = QueryToolHelpers::GetOccupant(thisPtr);
-
 			spNetworkQueryToolTipHookServer->SendAppendToolTipMessage(
 				pOccupant,
 				debugQueryEnabled,
@@ -82,10 +79,20 @@ namespace
 		cIGZString& title,
 		cIGZString& text)
 	{
-		if (!SetCustomToolTip(thisPtr, title, text))
+		HookTrace::Scope traceScope("HookedGetNetworkOccupantTipInfo");
+
+		const bool debugQuery = QueryToolHelpers::IsDebugQueryEnabled();
+		cISC4Occupant* const pOccupant = QueryToolHelpers::GetOccupant(thisPtr);
+
+		if (!ToolTipCache::TryGet(pOccupant, debugQuery, title, text))
 		{
-			RealGetNetworkOccupantTipInfo(thisPtr, title, text);
-			SetAppendedToolTipText(thisPtr, text);
+			if (!SetCustomToolTip(pOccupant, debugQuery, title, text))
+			{
+				RealGetNetworkOccupantTipInfo(thisPtr, title, text);
+				SetAppendedToolTipText(pOccupant, debugQuery, text);
+			}
+
+			ToolTipCache::Add(pOccupant, debugQuery, title, text);
 		}
 	}
 }
@@ -20,13 +20,13 @@
  */
 
 #pragma once
-#include "cINetworkQueryToolTipHookServer.h"
-#include <unordered_set>
+#include "cINetworkQueryToolTipHookServer2.h"
+#include "PrioritizedSubscriberList.h"
 
 class cISC4Occupant;
 class cIGZString;
 
-class NetworkQueryToolTipHookServer : public cINetworkQueryToolTipHookServer
+class NetworkQueryToolTipHookServer : public cINetworkQueryToolTipHookServer2
 {
 public:
 	NetworkQueryToolTipHookServer();
@@ -66,14 +66,16 @@ public:
 		cIGZString& destination);
 
 	bool AddNotification(cINetworkQueryCustomToolTipHookTarget* target) override;
+	bool AddNotification(cINetworkQueryCustomToolTipHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cINetworkQueryCustomToolTipHookTarget* target) override;
 
 	bool AddNotification(cIQueryToolTipAppendTextHookTarget* target) override;
+	bool AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cIQueryToolTipAppendTextHookTarget* target) override;
 
 private:
 	uint32_t refCount;
-	std::unordered_set<cINetworkQueryCustomToolTipHookTarget*> customToolTipHookSubscribers;
-	std::unordered_set<cIQueryToolTipAppendTextHookTarget*> appendToolTipHookSubscribers;
+	PrioritizedSubscriberList<cINetworkQueryCustomToolTipHookTarget> customToolTipHookSubscribers;
+	PrioritizedSubscriberList<cIQueryToolTipAppendTextHookTarget> appendToolTipHookSubscribers;
 };
 
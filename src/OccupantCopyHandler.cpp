@@ -22,6 +22,7 @@
 #include "OccupantCopyHandler.h"
 #include "ClickToCopyOccupantFilter.h"
 #include "GlobalSC4InterfacePointers.h"
+#include "HookTrace.h"
 #include "cIGZAllocatorService.h"
 #include "cIGZWin.h"
 #include "cIGZWinMgr.h"
@@ -266,6 +267,8 @@ namespace
 
 bool OccupantCopyHandler::Execute(int32_t mouseX, int32_t mouseY)
 {
+	HookTrace::Scope traceScope("OccupantCopyHandler::Execute");
+
 	bool result = false;
 
 	cRZAutoRefCount<cISC4View3DWin> pView3D = SC4UI::GetView3DWin();
@@ -0,0 +1,122 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A list of hook subscribers that is ordered by priority.
+ *
+ * Subscribers with a higher priority come first, subscribers with the same priority
+ * keep the order that they were added in. The subscribers are stored in a contiguous
+ * array so that the frequent notification dispatch does not have to chase nodes.
+ * @tparam T The subscriber interface type.
+ */
+template <typename T>
+class PrioritizedSubscriberList
+{
+public:
+	using const_iterator = typename std::vector<T*>::const_iterator;
+
+	/**
+	 * @brief Adds a subscriber.
+	 * @param target The subscriber.
+	 * @param priority The subscriber priority.
+	 * @return true if the subscriber was added; otherwise, false if it is null or already in the list.
+	 */
+	bool Add(T* target, int32_t priority)
+	{
+		if (!target || Find(target) != targets.size())
+		{
+			return false;
+		}
+
+		size_t index = 0;
+
+		while (index < priorities.size() && priorities[index] >= priority)
+		{
+			index++;
+		}
+
+		targets.insert(targets.begin() + index, target);
+		priorities.insert(priorities.begin() + index, priority);
+		return true;
+	}
+
+	/**
+	 * @brief Removes a subscriber.
+	 * @param target The subscriber.
+	 * @return true if the subscriber was removed; otherwise, false if it is not in the list.
+	 */
+	bool Remove(T* target)
+	{
+		const size_t index = Find(target);
+
+		if (!target || index == targets.size())
+		{
+			return false;
+		}
+
+		targets.erase(targets.begin() + index);
+		priorities.erase(priorities.begin() + index);
+		return true;
+	}
+
+	bool empty() const
+	{
+		return targets.empty();
+	}
+
+	size_t size() const
+	{
+		return targets.size();
+	}
+
+	const_iterator begin() const
+	{
+		return targets.begin();
+	}
+
+	const_iterator end() const
+	{
+		return targets.end();
+	}
+
+private:
+	size_t Find(T* target) const
+	{
+		size_t index = 0;
+
+		while (index < targets.size() && targets[index] != target)
+		{
+			index++;
+		}
+
+		return index;
+	}
+
+	// The priorities are kept in a separate array so that iterating
+	// the subscribers only touches the subscriber pointers.
+	std::vector<T*> targets;
+	std::vector<int32_t> priorities;
+};
@@ -23,9 +23,11 @@
 #include "cIGZString.h"
 #include "PropQueryToolTipHookServer.h"
 #include "GlobalHookServerPointers.h"
+#include "HookTrace.h"
 #include "OccupantUtil.h"
 #include "Patcher.h"
 #include "QueryToolHelpers.h"
+#include "ToolTipCache.h"
 
 namespace
 {
@@ -69,13 +71,20 @@ namespace
 		cIGZString& title,
 		cIGZString& text)
 	{
+		HookTrace::Scope traceScope("HookedGetPropOccupantTipInfo");
+
 		const bool debugQuery = QueryToolHelpers::IsDebugQueryEnabled();
 		cISC4Occupant* const pOccupant = QueryToolHelpers::GetOccupant(thisPtr);
 
-		if (!SetCustomToolTip(pOccupant, debugQuery, title, text))
+		if (!ToolTipCache::TryGet(pOccupant, debugQuery, title, text))
 		{
-			OccupantUtil::GetDisplayName(pOccupant, title);
-			SetAppendedToolTipText(pOccupant, debugQuery, text);
+			if (!SetCustomToolTip(pOccupant, debugQuery, title, text))
+			{
+				OccupantUtil::GetDisplayName(pOccupant, title);
+				SetAppendedToolTipText(pOccupant, debugQuery, text);
+			}
+
+			ToolTipCache::Add(pOccupant, debugQuery, title, text);
 		}
 	}
 }
@@ -24,6 +24,10 @@
 #include "cIQueryToolTipAppendTextHookTarget.h"
 #include "cRZBaseString.h"
 #include "GZStringUtil.h"
+#include "SubscriberStatistics.h"
+
+static constexpr const char* CustomToolTipHookName = "PropQueryToolTipHookServer custom tool tip hook";
+static constexpr const char* AppendToolTipHookName = "PropQueryToolTipHookServer append tool tip hook";
 
 PropQueryToolTipHookServer::PropQueryToolTipHookServer()
 	: refCount(0)
@@ -32,7 +36,13 @@ PropQueryToolTipHookServer::PropQueryToolTipHookServer()
 
 bool PropQueryToolTipHookServer::QueryInterface(uint32_t riid, void** ppvObj)
 {
-	if (riid == GZIID_cIPropQueryToolTipHookServer)
+	if (riid == GZIID_cIPropQueryToolTipHookServer2)
+	{
+		*ppvObj = static_cast<cIPropQueryToolTipHookServer2*>(this);
+		AddRef();
+		return true;
+	}
+	else if (riid == GZIID_cIPropQueryToolTipHookServer)
 	{
 		*ppvObj = static_cast<cIPropQueryToolTipHookServer*>(this);
 		AddRef();
@@ -86,7 +96,9 @@ bool PropQueryToolTipHookServer::SendCustomToolTipMessage(
 
 			if (localTarget)
 			{
-				if (localTarget->ProcessToolTip(
+				SubscriberStatistics::ScopedCall call(CustomToolTipHookName, localTarget);
+
+				if (!call.IsSkipped() && localTarget->ProcessToolTip(
 					occupant,
 					debugQuery,
 					title,
@@ -109,7 +121,7 @@ bool PropQueryToolTipHookServer::HasAppendToolTipSubscribers() const
 
 void PropQueryToolTipHookServer::SendAppendToolTipMessage(cISC4Occupant* const occupant, bool debugQuery, cIGZString& destination)
 {
-	size_t subscriberCount = customToolTipHookSubscribers.size();
+	size_t subscriberCount = appendToolTipHookSubscribers.size();
 	if (subscriberCount > 0)
 	{
 		for (cIQueryToolTipAppendTextHookTarget* pTarget : appendToolTipHookSubscribers)
@@ -118,9 +130,10 @@ void PropQueryToolTipHookServer::SendAppendToolTipMessage(cISC4Occupant* const o
 
 			if (localTarget)
 			{
+				SubscriberStatistics::ScopedCall call(AppendToolTipHookName, localTarget);
 				cRZBaseString text;
 
-				if (localTarget->AppendQueryToolTipText(
+				if (!call.IsSkipped() && localTarget->AppendQueryToolTipText(
 					occupant,
 					debugQuery,
 					text))
@@ -134,48 +147,30 @@ void PropQueryToolTipHookServer::SendAppendToolTipMessage(cISC4Occupant* const o
 
 bool PropQueryToolTipHookServer::AddNotification(cIPropQueryCustomToolTipHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = customToolTipHookSubscribers.emplace(target).second;
-	}
+	return AddNotification(target, QueryHookDefaultPriority);
+}
 
-	return result;
+bool PropQueryToolTipHookServer::AddNotification(cIPropQueryCustomToolTipHookTarget* target, int32_t priority)
+{
+	return customToolTipHookSubscribers.Add(target, priority);
 }
 
 bool PropQueryToolTipHookServer::RemoveNotification(cIPropQueryCustomToolTipHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = customToolTipHookSubscribers.erase(target) == 1;
-	}
-
-	return result;
+	return customToolTipHookSubscribers.Remove(target);
 }
 
 bool PropQueryToolTipHookServer::AddNotification(cIQueryToolTipAppendTextHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = appendToolTipHookSubscribers.emplace(target).second;
-	}
+	return AddNotification(target, QueryHookDefaultPriority);
+}
 
-	return result;
+bool PropQueryToolTipHookServer::AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority)
+{
+	return appendToolTipHookSubscribers.Add(target, priority);
 }
 
 bool PropQueryToolTipHookServer::RemoveNotification(cIQueryToolTipAppendTextHookTarget* target)
 {
-	bool result = false;
-
-	if (target)
-	{
-		result = appendToolTipHookSubscribers.erase(target) == 1;
-	}
-
-	return result;
+	return appendToolTipHookSubscribers.Remove(target);
 }
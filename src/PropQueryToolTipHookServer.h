@@ -20,13 +20,13 @@
  */
 
 #pragma once
-#include "cIPropQueryToolTipHookServer.h"
-#include <unordered_set>
+#include "cIPropQueryToolTipHookServer2.h"
+#include "PrioritizedSubscriberList.h"
 
 class cISC4Occupant;
 class cIGZString;
 
-class PropQueryToolTipHookServer : public cIPropQueryToolTipHookServer
+class PropQueryToolTipHookServer : public cIPropQueryToolTipHookServer2
 {
 public:
 	PropQueryToolTipHookServer();
@@ -66,14 +66,16 @@ public:
 		cIGZString& destination);
 
 	bool AddNotification(cIPropQueryCustomToolTipHookTarget* target) override;
+	bool AddNotification(cIPropQueryCustomToolTipHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cIPropQueryCustomToolTipHookTarget* target) override;
 
 	bool AddNotification(cIQueryToolTipAppendTextHookTarget* target) override;
+	bool AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority) override;
 	bool RemoveNotification(cIQueryToolTipAppendTextHookTarget* target) override;
 
 private:
 	uint32_t refCount;
-	std::unordered_set<cIPropQueryCustomToolTipHookTarget*> customToolTipHookSubscribers;
-	std::unordered_set<cIQueryToolTipAppendTextHookTarget*> appendToolTipHookSubscribers;
+	PrioritizedSubscriberList<cIPropQueryCustomToolTipHookTarget> customToolTipHookSubscribers;
+	PrioritizedSubscriberList<cIQueryToolTipAppendTextHookTarget> appendToolTipHookSubscribers;
 };
 
@@ -20,6 +20,10 @@
  */
 
 #include "QueryToolHelpers.h"
+#include "cIGZDate.h"
+#include "cISC4City.h"
+#include "cISC4Simulator.h"
+#include "GlobalSC4InterfacePointers.h"
 #include "Windows.h"
 #include <cstdint>
 
@@ -48,3 +52,25 @@ cISC4Occupant* QueryToolHelpers::GetOccupant(void* thisPtr)
 	const intptr_t occupantAddress = *reinterpret_cast<intptr_t*>(reinterpret_cast<intptr_t>(thisPtr) + 0x2C);
 	return reinterpret_cast<cISC4Occupant*>(occupantAddress);
 }
+
+uint32_t QueryToolHelpers::GetSimDayNumber()
+{
+	uint32_t dayNumber = 0;
+
+	if (spCity)
+	{
+		cISC4Simulator* pSimulator = spCity->GetSimulator();
+
+		if (pSimulator)
+		{
+			cIGZDate* pDate = pSimulator->GetSimDate();
+
+			if (pDate)
+			{
+				dayNumber = pDate->DayNumber();
+			}
+		}
+	}
+
+	return dayNumber;
+}
@@ -20,6 +20,7 @@
  */
 
 #pragma once
+#include <cstdint>
 
 class cISC4Occupant;
 
@@ -28,4 +29,8 @@ namespace QueryToolHelpers
 	bool IsDebugQueryEnabled();
 
 	cISC4Occupant* GetOccupant(void* thisPtr);
+
+	// Gets the current simulation day number, or 0 if a city is not loaded.
+	// The query tool caches use it to refresh their values once per simulation day.
+	uint32_t GetSimDayNumber();
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include "version.h"
 #include "BuildingQueryHooks.h"
 #include "BuildingQueryHookServer.h"
+#include "BuildingQueryVariableRegistry.h"
 #include "BuildingQueryVariablesProvider.h"
 #include "FloraQueryHooks.h"
 #include "FloraQueryToolTipHookServer.h"
@@ -31,13 +32,20 @@
 #include "PropQueryToolTipHookServer.h"
 #include "QueryToolTipProvider.h"
 #include "TerrainQueryHooks.h"
+#include "TerrainQueryToolTipHookServer.h"
 #include "FileSystem.h"
 #include "GlobalHookServerPointers.h"
 #include "GlobalSC4InterfacePointers.h"
+#include "HookTrace.h"
 #include "Logger.h"
 #include "SC4VersionDetection.h"
 #include "Settings.h"
+#include "SimGridExporter.h"
+#include "SimulationEpoch.h"
+#include "SubscriberStatistics.h"
+#include "ToolTipCache.h"
 #include "cIGZApp.h"
+#include "cIGZCheatCodeManager.h"
 #include "cIGZCmdLine.h"
 #include "cIGZCOM.h"
 #include "cIGZFrameWork.h"
@@ -71,19 +79,29 @@
 
 static constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
 static constexpr uint32_t kSC4MessagePreCityShutdown = 0x26D31EC2;
+static constexpr uint32_t kSC4MessageSimNewMonth = 0x66956816;
+static constexpr uint32_t kSC4MessageRemoveOccupant = 0x99EF1143;
+static constexpr uint32_t kMessageCheatIssued = 0x230E27AC;
 
-static constexpr std::array<uint32_t, 2> RequiredNotifications =
+static constexpr uint32_t kExportSimGridsCheatID = 0x1F6C0A3D;
+static constexpr const char* kExportSimGridsCheatString = "ExportSimGrids";
+
+static constexpr std::array<uint32_t, 4> RequiredNotifications =
 {
 	kSC4MessagePostCityInit,
-	kSC4MessagePreCityShutdown
+	kSC4MessagePreCityShutdown,
+	kSC4MessageSimNewMonth,
+	kSC4MessageRemoveOccupant,
 };
 
 static constexpr uint32_t kQueryDialogHooksDirectorID = 0x5EBF9B1E;
 
 BuildingQueryHookServer* spBuildingQueryHookServer = nullptr;
+BuildingQueryVariableRegistry* spBuildingQueryVariableRegistry = nullptr;
 FloraQueryToolTipHookServer* spFloraQueryToolTipHookServer = nullptr;
 NetworkQueryToolTipHookServer* spNetworkQueryToolTipHookServer = nullptr;
 PropQueryToolTipHookServer* spPropQueryToolTipHookServer = nullptr;
+TerrainQueryToolTipHookServer* spTerrainQueryToolTipHookServer = nullptr;
 
 cRZAutoRefCount<cIGZLanguageManager> spLanguageManager;
 cISC4AuraSimulator* spAuraSimulator = nullptr;
@@ -110,7 +128,7 @@ namespace
 				NetworkQueryHooks::Install();
 				FloraQueryHooks::Install();
 				PropQueryHooks::Install();
-				TerrainQueryHooks::Install();
+				TerrainQueryHooks::Install(settings);
 
 				logger.WriteLine(LogLevel::Info, "Installed the query UI hooks.");
 			}
@@ -142,9 +160,11 @@ public:
 		  buildingQueryVariablesProvider(settings)
 	{
 		spBuildingQueryHookServer = &buildingQueryHookServer;
+		spBuildingQueryVariableRegistry = &buildingQueryVariableRegistry;
 		spFloraQueryToolTipHookServer = &floraQueryToolTipHookServer;
 		spNetworkQueryToolTipHookServer = &networkQueryToolTipHookServer;
 		spPropQueryToolTipHookServer = &propQueryToolTipHookServer;
+		spTerrainQueryToolTipHookServer = &terrainQueryToolTipHookServer;
 
 		Logger& logger = Logger::GetInstance();
 		logger.WriteLogFileHeader("SC4QueryUIHooks v" PLUGIN_VERSION_STR);
@@ -158,6 +178,10 @@ public:
 		{
 			result = buildingQueryHookServer.QueryInterface(riid, ppvObj);
 		}
+		else if (rclsid == GZCLSID_cIBuildingQueryVariableRegistry)
+		{
+			result = buildingQueryVariableRegistry.QueryInterface(riid, ppvObj);
+		}
 		else if (rclsid == GZCLSID_cINetworkQueryToolTipHookServer)
 		{
 			result = networkQueryToolTipHookServer.QueryInterface(riid, ppvObj);
@@ -170,6 +194,10 @@ public:
 		{
 			result = propQueryToolTipHookServer.QueryInterface(riid, ppvObj);
 		}
+		else if (rclsid == GZCLSID_cITerrainQueryToolTipHookServer)
+		{
+			result = terrainQueryToolTipHookServer.QueryInterface(riid, ppvObj);
+		}
 
 		return result;
 	}
@@ -186,9 +214,11 @@ public:
 		if (gameVersion == 641)
 		{
 			pCallback(GZCLSID_cIBuildingQueryHookServer, 0, pContext);
+			pCallback(GZCLSID_cIBuildingQueryVariableRegistry, 0, pContext);
 			pCallback(GZCLSID_cINetworkQueryToolTipHookServer, 0, pContext);
 			pCallback(GZCLSID_cIFloraQueryToolTipHookServer, 0, pContext);
 			pCallback(GZCLSID_cIPropQueryToolTipHookServer, 0, pContext);
+			pCallback(GZCLSID_cITerrainQueryToolTipHookServer, 0, pContext);
 		}
 	}
 
@@ -199,6 +229,8 @@ public:
 
 	void PostCityInit(cIGZMessage2Standard* pStandardMsg)
 	{
+		SimulationEpoch::Advance();
+
 		spCity = static_cast<cISC4City*>(pStandardMsg->GetVoid1());
 
 		if (spCity)
@@ -224,6 +256,29 @@ public:
 		spWeatherSimulator = nullptr;
 		buildingQueryVariablesProvider.PreCityShutdown(pStandardMsg, mpCOM);
 		queryToolTipProvider.PreCityShutdown(pStandardMsg, mpCOM);
+		ToolTipCache::Clear();
+		SubscriberStatistics::LogSlowestSubscribers();
+
+		SimulationEpoch::Advance();
+	}
+
+	void ProcessCheat(cIGZMessage2Standard* pStandardMsg)
+	{
+		const uint32_t cheatID = static_cast<uint32_t>(pStandardMsg->GetData1());
+
+		if (cheatID == kExportSimGridsCheatID)
+		{
+			Logger& logger = Logger::GetInstance();
+
+			if (SimGridExporter::Export(FileSystem::GetSimGridExportFilePath()))
+			{
+				logger.WriteLine(LogLevel::Info, "Exported the sim grids.");
+			}
+			else
+			{
+				logger.WriteLine(LogLevel::Error, "Failed to export the sim grids.");
+			}
+		}
 	}
 
 	bool DoMessage(cIGZMessage2* pMsg)
@@ -238,6 +293,15 @@ public:
 		case kSC4MessagePreCityShutdown:
 			PreCityShutdown(pStandardMsg);
 			break;
+		case kSC4MessageSimNewMonth:
+			SimulationEpoch::Advance();
+			break;
+		case kSC4MessageRemoveOccupant:
+			ToolTipCache::Remove(static_cast<cISC4Occupant*>(pStandardMsg->GetVoid1()));
+			break;
+		case kMessageCheatIssued:
+			ProcessCheat(pStandardMsg);
+			break;
 		}
 
 		return true;
@@ -248,6 +312,15 @@ public:
 		mpFrameWork->AddHook(this);
 
 		settings.Load();
+		SubscriberStatistics::SetTimeBudget(settings.SubscriberTimeBudgetMilliseconds());
+
+		if (settings.EnableHookTrace())
+		{
+			if (!HookTrace::Start(FileSystem::GetHookTraceFilePath()))
+			{
+				Logger::GetInstance().WriteLine(LogLevel::Error, "Failed to create the hook trace file.");
+			}
+		}
 
 		InstallQueryUIHooks(settings);
 
@@ -275,6 +348,16 @@ public:
 			if (pApp->QueryInterface(GZIID_cISC4App, pSC4App.AsPPVoid()))
 			{
 				spStringDetokenizer = pSC4App->GetStringDetokenizer();
+
+				cIGZCheatCodeManager* pCheatMgr = pSC4App->GetCheatCodeManager();
+
+				if (pCheatMgr)
+				{
+					pCheatMgr->AddNotification2(this, 0);
+					pCheatMgr->RegisterCheatCode(
+						kExportSimGridsCheatID,
+						cRZBaseString(kExportSimGridsCheatString));
+				}
 			}
 		}
 
@@ -289,21 +372,52 @@ public:
 
 	bool PreAppShutdown()
 	{
+		cIGZMessageServer2Ptr pMsgServ;
+
+		if (pMsgServ)
+		{
+			for (uint32_t messageID : RequiredNotifications)
+			{
+				pMsgServ->RemoveNotification(this, messageID);
+			}
+		}
+
+		cIGZApp* const pApp = mpFrameWork->Application();
+
+		if (pApp)
+		{
+			cRZAutoRefCount<cISC4App> pSC4App;
+
+			if (pApp->QueryInterface(GZIID_cISC4App, pSC4App.AsPPVoid()))
+			{
+				cIGZCheatCodeManager* pCheatMgr = pSC4App->GetCheatCodeManager();
+
+				if (pCheatMgr)
+				{
+					pCheatMgr->UnregisterCheatCode(kExportSimGridsCheatID);
+					pCheatMgr->RemoveNotification2(this, 0);
+				}
+			}
+		}
+
 		buildingQueryVariablesProvider.PreAppShutdown(mpCOM);
 		queryToolTipProvider.PreAppShutdown(mpCOM);
 		spLanguageManager.Reset();
+		HookTrace::Stop();
 
 		return true;
 	}
 
 private:
 	BuildingQueryHookServer buildingQueryHookServer;
+	BuildingQueryVariableRegistry buildingQueryVariableRegistry;
 	BuildingQueryVariablesProvider buildingQueryVariablesProvider;
 	FloraQueryToolTipHookServer floraQueryToolTipHookServer;
 	NetworkQueryToolTipHookServer networkQueryToolTipHookServer;
 	PropQueryToolTipHookServer propQueryToolTipHookServer;
 	QueryToolTipProvider queryToolTipProvider;
 	Settings settings;
+	TerrainQueryToolTipHookServer terrainQueryToolTipHookServer;
 };
 
 cRZCOMDllDirector* RZGetCOMDllDirector() {
@@ -27,7 +27,12 @@
 
 Settings::Settings()
 	: enableOccupantQuerySounds(true),
-	  logBuildingPluginPath(false)
+	  logBuildingPluginPath(false),
+	  subscriberTimeBudgetMilliseconds(0),
+	  enableHookTrace(false),
+	  terrainQueryAggregateRadius(8),
+	  recordLuaTestFixture(false),
+	  benchmarkDetokenizerRegistration(false)
 {
 }
 
@@ -41,6 +46,31 @@ bool Settings::LogBuildingPluginPath() const
 	return logBuildingPluginPath;
 }
 
+uint32_t Settings::SubscriberTimeBudgetMilliseconds() const
+{
+	return subscriberTimeBudgetMilliseconds;
+}
+
+bool Settings::EnableHookTrace() const
+{
+	return enableHookTrace;
+}
+
+uint32_t Settings::TerrainQueryAggregateRadius() const
+{
+	return terrainQueryAggregateRadius;
+}
+
+bool Settings::RecordLuaTestFixture() const
+{
+	return recordLuaTestFixture;
+}
+
+bool Settings::BenchmarkDetokenizerRegistration() const
+{
+	return benchmarkDetokenizerRegistration;
+}
+
 void Settings::Load()
 {
 	Logger& logger = Logger::GetInstance();
@@ -57,6 +87,11 @@ void Settings::Load()
 
 			enableOccupantQuerySounds = queryUIHooksSection.get_converted_value<bool>("EnableOccupantQuerySounds");
 			logBuildingPluginPath = queryUIHooksSection.get_converted_value<bool>("LogBuildingPluginPath");
+			subscriberTimeBudgetMilliseconds = queryUIHooksSection.get_converted_value<uint32_t>("SubscriberTimeBudgetMilliseconds");
+			enableHookTrace = queryUIHooksSection.get_converted_value<bool>("EnableHookTrace");
+			terrainQueryAggregateRadius = queryUIHooksSection.get_converted_value<uint32_t>("TerrainQueryAggregateRadius");
+			recordLuaTestFixture = queryUIHooksSection.get_converted_value<bool>("RecordLuaTestFixture");
+			benchmarkDetokenizerRegistration = queryUIHooksSection.get_converted_value<bool>("BenchmarkDetokenizerRegistration");
 		}
 		else
 		{
@@ -35,10 +35,20 @@ private:
 
 	bool EnableOccupantQuerySounds() const override;
 	bool LogBuildingPluginPath() const override;
+	uint32_t SubscriberTimeBudgetMilliseconds() const override;
+	bool EnableHookTrace() const override;
+	uint32_t TerrainQueryAggregateRadius() const override;
+	bool RecordLuaTestFixture() const override;
+	bool BenchmarkDetokenizerRegistration() const override;
 
 	// Private members
 
 	bool enableOccupantQuerySounds;
 	bool logBuildingPluginPath;
+	uint32_t subscriberTimeBudgetMilliseconds;
+	bool enableHookTrace;
+	uint32_t terrainQueryAggregateRadius;
+	bool recordLuaTestFixture;
+	bool benchmarkDetokenizerRegistration;
 };
 
@@ -0,0 +1,148 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SimGridExportWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	uint32_t GetValueSize(SimGridExportValueType type)
+	{
+		uint32_t size = 0;
+
+		switch (type)
+		{
+		case SimGridExportValueType::UInt8:
+		case SimGridExportValueType::Int8:
+			size = 1;
+			break;
+		case SimGridExportValueType::Int32:
+		case SimGridExportValueType::Float32:
+			size = 4;
+			break;
+		}
+
+		return size;
+	}
+
+	uint64_t AlignToPage(uint64_t offset)
+	{
+		return (offset + (SimGridExportPageSize - 1)) & ~static_cast<uint64_t>(SimGridExportPageSize - 1);
+	}
+
+	void WritePadding(std::ofstream& stream, uint64_t currentOffset, uint64_t targetOffset)
+	{
+		static const char zeros[SimGridExportPageSize] = {};
+
+		stream.write(zeros, static_cast<std::streamsize>(targetOffset - currentOffset));
+	}
+}
+
+SimGridExportWriter::SimGridExportWriter(uint32_t cellCountX, uint32_t cellCountZ)
+	: cellCountX(cellCountX),
+	  cellCountZ(cellCountZ),
+	  columns()
+{
+}
+
+void SimGridExportWriter::AddColumn(const char* name, SimGridExportValueType valueType, RowReader rowReader)
+{
+	ColumnWriter writer{};
+
+	const size_t nameLength = std::min<size_t>(std::strlen(name), SimGridExportColumnNameLength - 1);
+	std::memcpy(writer.column.name, name, nameLength);
+	writer.column.valueType = valueType;
+	writer.column.valueSize = GetValueSize(valueType);
+	writer.rowReader = std::move(rowReader);
+
+	columns.push_back(std::move(writer));
+}
+
+bool SimGridExportWriter::Write(const std::filesystem::path& path) const
+{
+	SimGridExportHeader header{};
+	std::memcpy(header.magic, SimGridExportMagic, sizeof(SimGridExportMagic));
+	header.version = SimGridExportVersion;
+	header.headerSize = sizeof(SimGridExportHeader);
+	header.pageSize = SimGridExportPageSize;
+	header.cellCountX = cellCountX;
+	header.cellCountZ = cellCountZ;
+	header.columnCount = static_cast<uint32_t>(columns.size());
+	header.columnTableOffset = sizeof(SimGridExportHeader);
+
+	std::vector<SimGridExportColumn> columnTable;
+	columnTable.reserve(columns.size());
+
+	const uint64_t cellCount = static_cast<uint64_t>(cellCountX) * cellCountZ;
+	uint64_t offset = AlignToPage(header.columnTableOffset + columns.size() * sizeof(SimGridExportColumn));
+
+	for (const ColumnWriter& writer : columns)
+	{
+		SimGridExportColumn column = writer.column;
+		column.offset = offset;
+		column.size = cellCount * column.valueSize;
+
+		columnTable.push_back(column);
+		offset = AlignToPage(offset + column.size);
+	}
+
+	header.fileSize = offset;
+
+	std::ofstream stream(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(columnTable.data()), static_cast<std::streamsize>(columnTable.size() * sizeof(SimGridExportColumn)));
+
+	uint64_t currentOffset = header.columnTableOffset + columnTable.size() * sizeof(SimGridExportColumn);
+	std::vector<uint8_t> row;
+
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		const SimGridExportColumn& column = columnTable[i];
+
+		WritePadding(stream, currentOffset, column.offset);
+		currentOffset = column.offset;
+
+		const size_t rowSize = static_cast<size_t>(cellCountX) * column.valueSize;
+		row.assign(rowSize, 0);
+
+		for (uint32_t z = 0; z < cellCountZ; z++)
+		{
+			columns[i].rowReader(z, row.data());
+			stream.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(rowSize));
+		}
+
+		currentOffset += column.size;
+	}
+
+	WritePadding(stream, currentOffset, header.fileSize);
+
+	stream.close();
+
+	return !stream.fail();
+}
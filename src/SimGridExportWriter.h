@@ -0,0 +1,74 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SimGridExportFormat.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes sim grid values to a file in the SimGridExportFormat.h layout.
+ *
+ * The column offsets are computed from the city size before any data is written,
+ * so every column is streamed to the file in a single pass over its grid, one row
+ * at a time.
+ */
+class SimGridExportWriter
+{
+public:
+	/**
+	 * @brief A callback that fills the values of one row of cells.
+	 * @param z The row index.
+	 * @param values The destination, it has room for cellCountX values of the column type.
+	 */
+	using RowReader = std::function<void(uint32_t z, void* values)>;
+
+	SimGridExportWriter(uint32_t cellCountX, uint32_t cellCountZ);
+
+	/**
+	 * @brief Adds a column to the file.
+	 * @param name The column name, it is truncated to SimGridExportColumnNameLength - 1 characters.
+	 * @param valueType The type of the column values.
+	 * @param rowReader The callback that reads the column values.
+	 */
+	void AddColumn(const char* name, SimGridExportValueType valueType, RowReader rowReader);
+
+	/**
+	 * @brief Writes the header and all of the columns to the file.
+	 * @param path The file path, it is overwritten if it exists.
+	 * @return true if the file was written; otherwise, false.
+	 */
+	bool Write(const std::filesystem::path& path) const;
+
+private:
+	struct ColumnWriter
+	{
+		SimGridExportColumn column;
+		RowReader rowReader;
+	};
+
+	uint32_t cellCountX;
+	uint32_t cellCountZ;
+	std::vector<ColumnWriter> columns;
+};
@@ -0,0 +1,212 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SimGridExporter.h"
+#include "SimGridExportWriter.h"
+#include "cISC4AuraSimulator.h"
+#include "cISC4City.h"
+#include "cISC4FlammabilitySimulator.h"
+#include "cISC4LandValueSimulator.h"
+#include "cISC4PollutionSimulator.h"
+#include "cISC4SimGrid.h"
+#include "cISC4WeatherSimulator.h"
+#include "GlobalSC4InterfacePointers.h"
+
+namespace
+{
+	// The size of a city cell in meters.
+	// The weather simulator methods take a world position instead of a cell.
+	static constexpr float CellSizeInMeters = 16.0f;
+
+	float GetCellCenter(uint32_t cell)
+	{
+		return (static_cast<float>(cell) * CellSizeInMeters) + (CellSizeInMeters / 2.0f);
+	}
+
+	template<typename TGrid, typename TValue>
+	void ReadGridRow(const TGrid* pGrid, uint32_t cellCountX, uint32_t z, TValue* values)
+	{
+		for (uint32_t x = 0; x < cellCountX; x++)
+		{
+			values[x] = static_cast<TValue>(pGrid->GetCellValue(static_cast<int32_t>(x), static_cast<int32_t>(z)));
+		}
+	}
+
+	SimGridExportLandValueType GetLandValueType(uint32_t x, uint32_t z)
+	{
+		SimGridExportLandValueType type = SimGridExportLandValueType::Unknown;
+
+		switch (spLandValueSimulator->GetLandValueType(x, z))
+		{
+		case cISC4LandValueSimulator::LandValueType::Low:
+			type = SimGridExportLandValueType::Low;
+			break;
+		case cISC4LandValueSimulator::LandValueType::Medium:
+			type = SimGridExportLandValueType::Medium;
+			break;
+		case cISC4LandValueSimulator::LandValueType::High:
+			type = SimGridExportLandValueType::High;
+			break;
+		}
+
+		return type;
+	}
+}
+
+bool SimGridExporter::Export(const std::filesystem::path& path)
+{
+	if (!spCity || !spFlammabilitySimulator || !spLandValueSimulator || !spPollutionSimulator || !spWeatherSimulator)
+	{
+		return false;
+	}
+
+	const uint32_t cellCountX = static_cast<uint32_t>(spCity->CellCountX());
+	const uint32_t cellCountZ = static_cast<uint32_t>(spCity->CellCountZ());
+
+	SimGridExportWriter writer(cellCountX, cellCountZ);
+
+	writer.AddColumn(
+		"flammability",
+		SimGridExportValueType::UInt8,
+		[cellCountX](uint32_t z, void* values)
+		{
+			ReadGridRow(spFlammabilitySimulator->GetFlammabilityGrid(), cellCountX, z, static_cast<uint8_t*>(values));
+		});
+	writer.AddColumn(
+		"intrinsic_land_value",
+		SimGridExportValueType::UInt8,
+		[cellCountX](uint32_t z, void* values)
+		{
+			ReadGridRow(spLandValueSimulator->GetIntrinsicLandValueMap(), cellCountX, z, static_cast<uint8_t*>(values));
+		});
+	writer.AddColumn(
+		"land_value",
+		SimGridExportValueType::UInt8,
+		[cellCountX](uint32_t z, void* values)
+		{
+			uint8_t* const landValues = static_cast<uint8_t*>(values);
+
+			for (uint32_t x = 0; x < cellCountX; x++)
+			{
+				landValues[x] = spLandValueSimulator->GetLandValue(x, z);
+			}
+		});
+	writer.AddColumn(
+		"land_value_type",
+		SimGridExportValueType::UInt8,
+		[cellCountX](uint32_t z, void* values)
+		{
+			uint8_t* const landValueTypes = static_cast<uint8_t*>(values);
+
+			for (uint32_t x = 0; x < cellCountX; x++)
+			{
+				landValueTypes[x] = static_cast<uint8_t>(GetLandValueType(x, z));
+			}
+		});
+
+	if (spAuraSimulator)
+	{
+		writer.AddColumn(
+			"mayor_rating",
+			SimGridExportValueType::Int8,
+			[cellCountX](uint32_t z, void* values)
+			{
+				ReadGridRow(spAuraSimulator->GetAuraGrid(), cellCountX, z, static_cast<int8_t*>(values));
+			});
+	}
+
+	writer.AddColumn(
+		"air_pollution",
+		SimGridExportValueType::Int32,
+		[cellCountX](uint32_t z, void* values)
+		{
+			int32_t* const pollution = static_cast<int32_t*>(values);
+
+			for (uint32_t x = 0; x < cellCountX; x++)
+			{
+				spPollutionSimulator->GetAirValue(x, z, pollution[x]);
+			}
+		});
+	writer.AddColumn(
+		"water_pollution",
+		SimGridExportValueType::Int32,
+		[cellCountX](uint32_t z, void* values)
+		{
+			int32_t* const pollution = static_cast<int32_t*>(values);
+
+			for (uint32_t x = 0; x < cellCountX; x++)
+			{
+				spPollutionSimulator->GetWaterValue(x, z, pollution[x]);
+			}
+		});
+	writer.AddColumn(
+		"garbage_pollution",
+		SimGridExportValueType::Int32,
+		[cellCountX](uint32_t z, void* values)
+		{
+			int32_t* const pollution = static_cast<int32_t*>(values);
+
+			for (uint32_t x = 0; x < cellCountX; x++)
+			{
+				spPollutionSimulator->GetGarbageValue(x, z, pollution[x]);
+			}
+		});
+	writer.AddColumn(
+		"radioactive",
+		SimGridExportValueType::UInt8,
+		[cellCountX](uint32_t z, void* values)
+		{
+			uint8_t* const radioactive = static_cast<uint8_t*>(values);
+
+			for (uint32_t x = 0; x < cellCountX; x++)
+			{
+				radioactive[x] = spPollutionSimulator->IsRadioactive(x, z) ? 1 : 0;
+			}
+		});
+	writer.AddColumn(
+		"moisture",
+		SimGridExportValueType::UInt8,
+		[cellCountX](uint32_t z, void* values)
+		{
+			uint8_t* const moisture = static_cast<uint8_t*>(values);
+			const float worldZ = GetCellCenter(z);
+
+			for (uint32_t x = 0; x < cellCountX; x++)
+			{
+				moisture[x] = spWeatherSimulator->GetMoistureValue(GetCellCenter(x), worldZ);
+			}
+		});
+	writer.AddColumn(
+		"humidity",
+		SimGridExportValueType::Float32,
+		[cellCountX](uint32_t z, void* values)
+		{
+			float* const humidity = static_cast<float*>(values);
+			const float worldZ = GetCellCenter(z);
+
+			for (uint32_t x = 0; x < cellCountX; x++)
+			{
+				humidity[x] = spWeatherSimulator->GetHumidity(GetCellCenter(x), worldZ);
+			}
+		});
+
+	return writer.Write(path);
+}
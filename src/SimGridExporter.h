@@ -0,0 +1,35 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <filesystem>
+
+// Writes the city's flammability, land value, mayor rating, pollution and weather
+// grids to a file that uses the SimGridExportFormat.h layout.
+namespace SimGridExporter
+{
+	/**
+	 * @brief Exports the sim grids of the current city.
+	 * @param path The file path, it is overwritten if it exists.
+	 * @return true if the grids were exported; otherwise, false.
+	 */
+	bool Export(const std::filesystem::path& path);
+}
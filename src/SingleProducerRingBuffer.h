@@ -0,0 +1,95 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @brief A fixed-size lock-free ring buffer with a single producer thread and a
+ * single consumer thread.
+ *
+ * The producer never blocks or allocates, an item is dropped when the buffer is full.
+ * @tparam T The item type, it must be trivially copyable.
+ * @tparam Capacity The number of items in the buffer, must be a power of 2.
+ */
+template <typename T, size_t Capacity>
+class SingleProducerRingBuffer
+{
+	static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2.");
+	static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable.");
+
+public:
+	SingleProducerRingBuffer()
+		: head(0), tail(0), items()
+	{
+	}
+
+	SingleProducerRingBuffer(const SingleProducerRingBuffer&) = delete;
+	SingleProducerRingBuffer& operator=(const SingleProducerRingBuffer&) = delete;
+
+	/**
+	 * @brief Adds an item to the buffer. Must only be called from the producer thread.
+	 * @param item The item.
+	 * @return true if the item was added; otherwise, false if the buffer is full.
+	 */
+	bool TryPush(const T& item)
+	{
+		const size_t currentHead = head.load(std::memory_order_relaxed);
+
+		if ((currentHead - tail.load(std::memory_order_acquire)) == Capacity)
+		{
+			return false;
+		}
+
+		items[currentHead & (Capacity - 1)] = item;
+		head.store(currentHead + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Removes the oldest item from the buffer. Must only be called from the consumer thread.
+	 * @param item On success, receives the item.
+	 * @return true if an item was removed; otherwise, false if the buffer is empty.
+	 */
+	bool TryPop(T& item)
+	{
+		const size_t currentTail = tail.load(std::memory_order_relaxed);
+
+		if (currentTail == head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		item = items[currentTail & (Capacity - 1)];
+		tail.store(currentTail + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	// The producer and consumer indices are kept on separate cache lines so
+	// that the two threads do not invalidate each other's cache line on every item.
+	// The indices wrap around at the size_t maximum, which is a multiple of the capacity.
+	alignas(64) std::atomic<size_t> head;
+	alignas(64) std::atomic<size_t> tail;
+	alignas(64) T items[Capacity];
+};
@@ -0,0 +1,390 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SubscriberStatistics.h"
+#include "HookTrace.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <Windows.h>
+#include "wil/win32_helpers.h"
+
+// Bucket i of the latency histogram counts the calls that took less than 2^i
+// microseconds, the last bucket also counts all of the longer calls.
+static constexpr size_t LatencyHistogramBucketCount = 20;
+
+static constexpr size_t LoggedSubscriberCount = 5;
+
+extern "C" IMAGE_DOS_HEADER __ImageBase;
+
+namespace
+{
+	struct SubscriberModule
+	{
+		HMODULE handle;
+		const char* name;
+	};
+
+	std::string GetModuleName(HMODULE hModule)
+	{
+		std::string result;
+
+		wil::unique_cotaskmem_string modulePath = wil::GetModuleFileNameW(hModule);
+		const wchar_t* fileName = wcsrchr(modulePath.get(), L'\\');
+		fileName = fileName ? fileName + 1 : modulePath.get();
+
+		const int length = WideCharToMultiByte(CP_UTF8, 0, fileName, -1, nullptr, 0, nullptr, nullptr);
+
+		if (length > 1)
+		{
+			result.resize(static_cast<size_t>(length));
+			WideCharToMultiByte(CP_UTF8, 0, fileName, -1, result.data(), length, nullptr, nullptr);
+			result.resize(static_cast<size_t>(length) - 1);
+		}
+
+		return result;
+	}
+
+	// The module names are kept for the lifetime of the process because the trace
+	// events refer to them after the statistics entries have been removed.
+	const char* InternModuleName(std::string name)
+	{
+		static std::unordered_set<std::string> moduleNames;
+
+		return moduleNames.insert(std::move(name)).first->c_str();
+	}
+
+	// The subscriber is identified by the DLL that contains its virtual function table.
+	// The modules are cached by the virtual function table address, so the module is only
+	// looked up once for each subscriber class.
+	SubscriberModule GetSubscriberModule(const void* subscriber)
+	{
+		static std::unordered_map<const void*, SubscriberModule> modules;
+
+		const void* vtable = *static_cast<const void* const*>(subscriber);
+
+		auto it = modules.find(vtable);
+
+		if (it == modules.end())
+		{
+			SubscriberModule module{ nullptr, nullptr };
+			std::string name;
+
+			if (GetModuleHandleExW(
+				GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+				static_cast<LPCWSTR>(vtable),
+				&module.handle))
+			{
+				name = GetModuleName(module.handle);
+			}
+
+			if (name.empty())
+			{
+				name = "<unknown module>";
+			}
+
+			module.name = InternModuleName(std::move(name));
+
+			it = modules.emplace(vtable, module).first;
+		}
+
+		return it->second;
+	}
+}
+
+struct SubscriberStatistics::SubscriberEntry
+{
+	const char* hookName;
+	const void* subscriber;
+	// The module name is read when the entry is created because the subscriber
+	// may have been destroyed by the time the statistics are logged.
+	const char* moduleName;
+	uint64_t callCount;
+	std::chrono::nanoseconds totalTime;
+	std::chrono::nanoseconds maxTime;
+	std::array<uint32_t, LatencyHistogramBucketCount> histogram;
+	// The subscribers in this DLL are never skipped, the building query variables
+	// would stop working for the rest of the game session.
+	bool exempt;
+	// A subscriber that exceeds the time budget is marked as skipped when its
+	// next call starts, a call that is in progress is never interrupted.
+	bool skipPending;
+	bool skipped;
+
+	SubscriberEntry(const char* hookName, const void* subscriber, const SubscriberModule& module)
+		: hookName(hookName),
+		  subscriber(subscriber),
+		  moduleName(module.name),
+		  callCount(0),
+		  totalTime(0),
+		  maxTime(0),
+		  histogram(),
+		  exempt(module.handle == reinterpret_cast<HMODULE>(&__ImageBase)),
+		  skipPending(false),
+		  skipped(false)
+	{
+	}
+};
+
+namespace
+{
+	// The entries are keyed by the hook name, the subscriber module and the subscriber
+	// pointer, a subscriber from another module that reuses the address of a skipped
+	// subscriber does not inherit its skip state.
+	struct SubscriberKey
+	{
+		const char* hookName;
+		HMODULE module;
+		const void* subscriber;
+
+		bool operator==(const SubscriberKey& other) const noexcept
+		{
+			return hookName == other.hookName
+				&& module == other.module
+				&& subscriber == other.subscriber;
+		}
+	};
+
+	struct SubscriberKeyHash
+	{
+		size_t operator()(const SubscriberKey& key) const noexcept
+		{
+			size_t seed = std::hash<const char*>()(key.hookName);
+
+			for (const void* value : { static_cast<const void*>(key.module), key.subscriber })
+			{
+				seed ^= std::hash<const void*>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			}
+
+			return seed;
+		}
+	};
+
+	std::unordered_map<SubscriberKey, SubscriberStatistics::SubscriberEntry, SubscriberKeyHash> sEntries;
+	std::chrono::nanoseconds sTimeBudget(0);
+
+	SubscriberStatistics::SubscriberEntry& GetEntry(const char* hookName, const void* pSubscriber)
+	{
+		const SubscriberModule module = GetSubscriberModule(pSubscriber);
+		const SubscriberKey key{ hookName, module.handle, pSubscriber };
+
+		auto it = sEntries.find(key);
+
+		if (it == sEntries.end())
+		{
+			it = sEntries.emplace(key, SubscriberStatistics::SubscriberEntry(hookName, pSubscriber, module)).first;
+		}
+
+		return it->second;
+	}
+
+	size_t GetHistogramBucket(std::chrono::nanoseconds time)
+	{
+		const uint64_t microseconds = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::microseconds>(time).count());
+
+		size_t bucket = 0;
+
+		while (bucket < (LatencyHistogramBucketCount - 1) && (uint64_t(1) << bucket) <= microseconds)
+		{
+			bucket++;
+		}
+
+		return bucket;
+	}
+
+	// Returns the upper bound of the histogram bucket that contains the specified
+	// percentile of the calls, in microseconds.
+	uint64_t GetPercentileUpperBound(const SubscriberStatistics::SubscriberEntry& entry, uint32_t percentile)
+	{
+		const uint64_t threshold = (entry.callCount * percentile + 99) / 100;
+		uint64_t count = 0;
+
+		for (size_t i = 0; i < entry.histogram.size(); i++)
+		{
+			count += entry.histogram[i];
+
+			if (count >= threshold)
+			{
+				return uint64_t(1) << i;
+			}
+		}
+
+		return uint64_t(1) << (LatencyHistogramBucketCount - 1);
+	}
+
+}
+
+void SubscriberStatistics::SetTimeBudget(uint32_t budgetMilliseconds)
+{
+	sTimeBudget = std::chrono::milliseconds(budgetMilliseconds);
+}
+
+void SubscriberStatistics::LogSlowestSubscribers()
+{
+	std::vector<SubscriberEntry*> entries;
+	entries.reserve(sEntries.size());
+
+	for (auto& item : sEntries)
+	{
+		if (item.second.callCount > 0)
+		{
+			entries.push_back(&item.second);
+		}
+	}
+
+	if (!entries.empty())
+	{
+		const size_t count = std::min(entries.size(), LoggedSubscriberCount);
+
+		std::partial_sort(
+			entries.begin(),
+			entries.begin() + count,
+			entries.end(),
+			[](const SubscriberEntry* lhs, const SubscriberEntry* rhs)
+			{
+				return lhs->totalTime > rhs->totalTime;
+			});
+
+		Logger& logger = Logger::GetInstance();
+		logger.WriteLine(LogLevel::Info, "Slowest query hook subscribers:");
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const SubscriberEntry* pEntry = entries[i];
+
+			const double totalMilliseconds = std::chrono::duration<double, std::milli>(pEntry->totalTime).count();
+			const double maxMilliseconds = std::chrono::duration<double, std::milli>(pEntry->maxTime).count();
+
+			logger.WriteLineFormatted(
+				LogLevel::Info,
+				"    %s (0x%p) in %s: %llu calls, total %.3f ms, max %.3f ms, p50 < %llu us, p99 < %llu us",
+				pEntry->moduleName,
+				pEntry->subscriber,
+				pEntry->hookName,
+				static_cast<unsigned long long>(pEntry->callCount),
+				totalMilliseconds,
+				maxMilliseconds,
+				static_cast<unsigned long long>(GetPercentileUpperBound(*pEntry, 50)),
+				static_cast<unsigned long long>(GetPercentileUpperBound(*pEntry, 99)));
+		}
+	}
+
+	// The skipped subscribers are kept for the rest of the game session.
+	for (auto it = sEntries.begin(); it != sEntries.end();)
+	{
+		if (it->second.skipped || it->second.skipPending)
+		{
+			it->second.callCount = 0;
+			it->second.totalTime = std::chrono::nanoseconds(0);
+			it->second.maxTime = std::chrono::nanoseconds(0);
+			it->second.histogram.fill(0);
+			++it;
+		}
+		else
+		{
+			it = sEntries.erase(it);
+		}
+	}
+}
+
+SubscriberStatistics::ScopedCall::ScopedCall(const char* hookName, const void* pSubscriber)
+	: pEntry(&GetEntry(hookName, pSubscriber)),
+	  pSkipEntry(pEntry),
+	  start()
+{
+	if (pEntry->skipPending)
+	{
+		pEntry->skipPending = false;
+		pEntry->skipped = true;
+	}
+
+	if (!pEntry->skipped)
+	{
+		HookTrace::BeginSubscriberCall(hookName, pEntry->moduleName, pSubscriber);
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+SubscriberStatistics::ScopedCall::ScopedCall(
+	const char* hookName,
+	const char* pairedHookName,
+	const void* pSubscriber)
+	: pEntry(&GetEntry(hookName, pSubscriber)),
+	  pSkipEntry(&GetEntry(pairedHookName, pSubscriber)),
+	  start()
+{
+	// The skip state of the paired entry only changes when the paired call starts,
+	// so this call is made if and only if the paired call was made.
+	if (!pSkipEntry->skipped)
+	{
+		HookTrace::BeginSubscriberCall(hookName, pEntry->moduleName, pSubscriber);
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+SubscriberStatistics::ScopedCall::~ScopedCall()
+{
+	if (pSkipEntry->skipped)
+	{
+		return;
+	}
+
+	const std::chrono::nanoseconds time = std::chrono::steady_clock::now() - start;
+	HookTrace::End(pEntry->hookName);
+
+	pEntry->callCount++;
+	pEntry->totalTime += time;
+	pEntry->maxTime = std::max(pEntry->maxTime, time);
+	pEntry->histogram[GetHistogramBucket(time)]++;
+
+	// The first call is not checked against the budget because subscribers
+	// often perform their one-time initialization in it.
+	if (sTimeBudget.count() > 0
+		&& pEntry->callCount > 1
+		&& time > sTimeBudget
+		&& !pSkipEntry->skipPending)
+	{
+		pSkipEntry->skipPending = true;
+
+		Logger::GetInstance().WriteLineFormatted(
+			LogLevel::Error,
+			"%s (0x%p) took %.3f ms in %s, it will be skipped for the rest of the game session.",
+			pEntry->moduleName,
+			pEntry->subscriber,
+			std::chrono::duration<double, std::milli>(time).count(),
+			pEntry->hookName);
+	}
+}
+
+bool SubscriberStatistics::ScopedCall::IsSkipped() const
+{
+	return pSkipEntry->skipped;
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Records the call count and latency of each hook subscriber, so that a slow
+// third-party subscriber can be identified from the log.
+// A subscriber is identified by its interface pointer, the DLL that contains it and
+// the hook server dispatch method that called it.
+namespace SubscriberStatistics
+{
+	struct SubscriberEntry;
+
+	/**
+	 * @brief Sets the time that a single subscriber call may take before the subscriber
+	 * is skipped for the rest of the game session. The subscribers in this DLL are never skipped.
+	 * @param budgetMilliseconds The time budget in milliseconds, 0 to never skip a subscriber.
+	 */
+	void SetTimeBudget(uint32_t budgetMilliseconds);
+
+	/**
+	 * @brief Writes the subscribers with the highest total call time to the log file
+	 * and resets the call statistics. The skipped subscribers are not reset.
+	 */
+	void LogSlowestSubscribers();
+
+	/**
+	 * @brief Measures a single subscriber call.
+	 *
+	 * The call time is recorded when the instance goes out of scope.
+	 */
+	class ScopedCall
+	{
+	public:
+		/**
+		 * @brief Starts measuring a subscriber call.
+		 * @param hookName The name of the hook that is dispatched. Must be a string literal.
+		 * @param pSubscriber The subscriber interface pointer.
+		 */
+		ScopedCall(const char* hookName, const void* pSubscriber);
+		/**
+		 * @brief Starts measuring a subscriber call that is paired with an earlier call
+		 * to the same subscriber, e.g. the after dialog hook that must follow the before
+		 * dialog hook.
+		 *
+		 * The call is skipped only when the paired call was skipped, and a call that
+		 * exceeds the time budget causes the next paired call to be skipped instead.
+		 * This keeps the state that the subscriber sets in the paired call balanced.
+		 * @param hookName The name of the hook that is dispatched. Must be a string literal.
+		 * @param pairedHookName The name of the paired hook. Must be a string literal.
+		 * @param pSubscriber The subscriber interface pointer.
+		 */
+		ScopedCall(const char* hookName, const char* pairedHookName, const void* pSubscriber);
+		~ScopedCall();
+
+		ScopedCall(const ScopedCall&) = delete;
+		ScopedCall& operator=(const ScopedCall&) = delete;
+
+		/**
+		 * @brief Gets a value indicating whether the subscriber exceeded the time budget
+		 * and should not be called.
+		 */
+		bool IsSkipped() const;
+
+	private:
+		SubscriberEntry* pEntry;
+		SubscriberEntry* pSkipEntry;
+		std::chrono::steady_clock::time_point start;
+	};
+}
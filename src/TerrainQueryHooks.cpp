@@ -20,16 +20,29 @@
  */
 
 #include "TerrainQueryHooks.h"
+#include "GridReduction.h"
+#include "TerrainQueryCellInfo.h"
+#include "TerrainQueryToolTipHookServer.h"
 #include "cISC4AuraSimulator.h"
+#include "cISC4City.h"
 #include "cISC4FlammabilitySimulator.h"
 #include "cISC4LandValueSimulator.h"
 #include "cISC4PollutionSimulator.h"
 #include "cISC4SimGrid.h"
 #include "cISC4WeatherSimulator.h"
+#include "cRZBaseString.h"
 #include "cS3DVector2.h"
+#include "GlobalHookServerPointers.h"
 #include "GlobalSC4InterfacePointers.h"
+#include "GZStringUtil.h"
+#include "HookTrace.h"
 #include "Patcher.h"
+#include "QueryToolHelpers.h"
+#include "SimulationEpoch.h"
+#include <algorithm>
+#include <array>
 #include <cstdarg>
+#include <vector>
 #include <Windows.h>
 
 namespace
@@ -80,154 +93,430 @@ namespace
 		return grid->GetCellValue(x, z);
 	}
 
-	int32_t HookedTerrainQuerySprintf(void* rzStringThisPtr, const char* format, ...)
+	TerrainQueryLandValueType GetLandValueType(int32_t cellX, int32_t cellZ)
 	{
-		// Unpack the arguments that were passed to the function.
+		TerrainQueryLandValueType type = TerrainQueryLandValueType::Unknown;
 
-		va_list args;
-		va_start(args, format);
+		switch (spLandValueSimulator->GetLandValueType(cellX, cellZ))
+		{
+		case cISC4LandValueSimulator::LandValueType::Low:
+			type = TerrainQueryLandValueType::Low;
+			break;
+		case cISC4LandValueSimulator::LandValueType::Medium:
+			type = TerrainQueryLandValueType::Medium;
+			break;
+		case cISC4LandValueSimulator::LandValueType::High:
+			type = TerrainQueryLandValueType::High;
+			break;
+		}
 
-		float x = static_cast<float>(va_arg(args, double));
-		float y = static_cast<float>(va_arg(args, double));
-		float z = static_cast<float>(va_arg(args, double));
-		int32_t cellX = va_arg(args, int32_t);
-		int32_t cellZ = va_arg(args, int32_t);
+		return type;
+	}
 
-		va_end(args);
+	const char* GetLandValueTypeDescription(TerrainQueryLandValueType type)
+	{
+		const char* description = "Unknown";
 
-		int32_t result = 0;
+		switch (type)
+		{
+		case TerrainQueryLandValueType::Low:
+			description = "Low";
+			break;
+		case TerrainQueryLandValueType::Medium:
+			description = "Medium";
+			break;
+		case TerrainQueryLandValueType::High:
+			description = "High";
+			break;
+		}
 
-		if (spFlammabilitySimulator && spLandValueSimulator && spPollutionSimulator && spWeatherSimulator)
+		return description;
+	}
+
+	// Reads the simulation data of the cell once, so that the default tool tip and
+	// every subscriber can use it without querying the simulators again.
+	void ReadCellSimulationData(TerrainQueryCellInfo& cellInfo)
+	{
+		const int32_t cellX = cellInfo.cellX;
+		const int32_t cellZ = cellInfo.cellZ;
+
+		cellInfo.moisture = spWeatherSimulator->GetMoistureValue(cellInfo.x, cellInfo.z);
+		cellInfo.humidity = spWeatherSimulator->GetHumidity(cellInfo.x, cellInfo.z);
+
+		cS3DVector2 ambientWindDirection;
+
+		cellInfo.ambientWindSpeed = spWeatherSimulator->GetWindAtCell(cellX, cellZ, ambientWindDirection);
+		cellInfo.ambientWindDirectionX = ambientWindDirection.fX;
+		cellInfo.ambientWindDirectionY = ambientWindDirection.fY;
+
+		cellInfo.flammability = GetSimGridCellValue(
+			spFlammabilitySimulator->GetFlammabilityGrid(),
+			cellX,
+			cellZ);
+
+		cellInfo.intrinsicLandValue = GetSimGridCellValue(
+			spLandValueSimulator->GetIntrinsicLandValueMap(),
+			cellX,
+			cellZ);
+		cellInfo.totalLandValue = spLandValueSimulator->GetLandValue(cellX, cellZ);
+		cellInfo.landValueType = GetLandValueType(cellX, cellZ);
+
+		if (spAuraSimulator)
 		{
-			const ModifierKeys modifiers = GetActiveModifierKeys();
+			cellInfo.mayorRating = GetSimGridCellValue(
+				spAuraSimulator->GetAuraGrid(),
+				cellX,
+				cellZ);
+		}
 
-			if (modifiers == ModifierKeys::None
-				|| (modifiers & ModifierKeys::ControlAltShift) == ModifierKeys::ControlAltShift)
-			{
-				// Show the standard query with the cell moisture added.
-				// This info is also appended to the end of the Control + Alt + Shift advanced/debug
-				// queries, so it need to be fairly short.
-
-				uint8_t cellMoisture = spWeatherSimulator->GetMoistureValue(x, z);
-
-				result = RealRZStringSprintf(
-					rzStringThisPtr,
-					"x=%f y=%f z=%f\ncell x=%d cell z=%d cell moisture=%d",
-					x,
-					y,
-					z,
-					cellX,
-					cellZ,
-					cellMoisture);
-			}
-			else if ((modifiers & ModifierKeys::ControlAltShift) == ModifierKeys::Alt)
-			{
-				// Pressing the Alt key will show the humidity and ambient wind information, this data appears
-				// to be for the entire tile instead of varying per-cell.
-
-				float humidity = spWeatherSimulator->GetHumidity(x, z);
-
-				cS3DVector2 ambientWindDirection;
-
-				float ambientWindSpeed = spWeatherSimulator->GetWindAtCell(cellX, cellZ, ambientWindDirection);
-
-				result = RealRZStringSprintf(
-					rzStringThisPtr,
-					"x=%f y=%f z=%f\ncell x=%d cell z=%d cell humidity=%f\n"
-					"ambient wind speed=%f\nambient wind direction[0]=%f\nambient wind direction[1]=%f",
-					x,
-					y,
-					z,
-					cellX,
-					cellZ,
-					humidity,
-					ambientWindSpeed,
-					ambientWindDirection.fX,
-					ambientWindDirection.fY);
-			}
-			else if ((modifiers & ModifierKeys::ControlAltShift) == ModifierKeys::Control)
-			{
-				// Pressing the Control key will show the flammability, land value, and pollution.
+		spPollutionSimulator->GetAirValue(cellX, cellZ, cellInfo.airPollution);
+		spPollutionSimulator->GetWaterValue(cellX, cellZ, cellInfo.waterPollution);
+		spPollutionSimulator->GetGarbageValue(cellX, cellZ, cellInfo.garbagePollution);
+		cellInfo.radioactive = spPollutionSimulator->IsRadioactive(cellX, cellZ);
+
+		cellInfo.hasSimulationData = true;
+	}
+
+	// The simulation data of the last queried cell.
+	// The tool tip is refreshed many times while the cursor stays in the same cell,
+	// and switching between the modifier key layouts uses the same data.
+	struct CachedCellSimulationData
+	{
+		int32_t cellX;
+		int32_t cellZ;
+		uint32_t epoch;
+		uint32_t simDay;
+		TerrainQueryCellInfo cellInfo;
+	};
+
+	// The epoch starts at 1, so the empty entry never matches.
+	CachedCellSimulationData sCachedCell{};
 
-				uint8_t flammability = GetSimGridCellValue(
-					spFlammabilitySimulator->GetFlammabilityGrid(),
-					cellX,
-					cellZ);
+	void GetCellSimulationData(TerrainQueryCellInfo& cellInfo)
+	{
+		const uint32_t epoch = SimulationEpoch::Get();
+		const uint32_t simDay = QueryToolHelpers::GetSimDayNumber();
 
-				// Our land value fields use the same order as SC4's advanced/debug query.
+		if (sCachedCell.cellX == cellInfo.cellX
+			&& sCachedCell.cellZ == cellInfo.cellZ
+			&& sCachedCell.epoch == epoch
+			&& sCachedCell.simDay == simDay)
+		{
+			// The cached structure has the simulation data, the position and
+			// modifier keys of the current query are kept.
+			TerrainQueryCellInfo result = sCachedCell.cellInfo;
+			result.x = cellInfo.x;
+			result.y = cellInfo.y;
+			result.z = cellInfo.z;
+			result.modifierKeys = cellInfo.modifierKeys;
+
+			cellInfo = result;
+		}
+		else
+		{
+			ReadCellSimulationData(cellInfo);
+
+			sCachedCell.cellX = cellInfo.cellX;
+			sCachedCell.cellZ = cellInfo.cellZ;
+			sCachedCell.epoch = epoch;
+			sCachedCell.simDay = simDay;
+			sCachedCell.cellInfo = cellInfo;
+		}
+	}
+
+	// The aggregate query reduces the values of the cells within this many cells of the cursor.
+	int32_t sAggregateQueryRadius = 8;
+
+	enum AggregateQueryMetric : size_t
+	{
+		AggregateQueryMetricAirPollution = 0,
+		AggregateQueryMetricWaterPollution,
+		AggregateQueryMetricGarbagePollution,
+		AggregateQueryMetricLandValue,
+		AggregateQueryMetricFlammability,
+		AggregateQueryMetricMayorRating,
+		AggregateQueryMetricCount
+	};
+
+	static constexpr std::array<const char*, AggregateQueryMetricCount> AggregateQueryMetricNames =
+	{
+		"air",
+		"water",
+		"garbage",
+		"land value",
+		"flam",
+		"mayor rating",
+	};
 
-				uint8_t intrinsicLandValue = GetSimGridCellValue(
-					spLandValueSimulator->GetIntrinsicLandValueMap(),
-					cellX,
-					cellZ);
-				uint8_t totalLandValue = spLandValueSimulator->GetLandValue(cellX, cellZ);
-				const char* landValueDescription = "Unknown";
+	// The cell values are copied into contiguous buffers that are reused between queries,
+	// the reduction kernels then process each buffer in a single pass.
+	std::array<std::vector<int32_t>, AggregateQueryMetricCount> sAggregateQueryValues;
 
-				switch (spLandValueSimulator->GetLandValueType(cellX, cellZ))
+	// The aggregate statistics of the last queried cell, they use the same cache key as
+	// the cell simulation data so that the tool tip refreshes do not gather the cells again.
+	struct CachedAggregateStatistics
+	{
+		int32_t cellX;
+		int32_t cellZ;
+		uint32_t epoch;
+		uint32_t simDay;
+		int32_t radius;
+		uint32_t cellCount;
+		std::array<GridStatistics, AggregateQueryMetricCount> statistics;
+	};
+
+	// The epoch starts at 1, so the empty entry never matches.
+	CachedAggregateStatistics sCachedAggregate{};
+
+	void ComputeAggregateStatistics(int32_t cellX, int32_t cellZ, int32_t radius, CachedAggregateStatistics& result)
+	{
+		const int32_t radiusSquared = radius * radius;
+
+		const int32_t minX = std::max(cellX - radius, 0);
+		const int32_t maxX = std::min(cellX + radius, spCity->CellCountX() - 1);
+		const int32_t minZ = std::max(cellZ - radius, 0);
+		const int32_t maxZ = std::min(cellZ + radius, spCity->CellCountZ() - 1);
+
+		for (std::vector<int32_t>& values : sAggregateQueryValues)
+		{
+			values.clear();
+		}
+
+		const auto* const pFlammabilityGrid = spFlammabilitySimulator->GetFlammabilityGrid();
+		const auto* const pAuraGrid = spAuraSimulator ? spAuraSimulator->GetAuraGrid() : nullptr;
+
+		for (int32_t z = minZ; z <= maxZ; z++)
+		{
+			const int32_t dz = z - cellZ;
+
+			for (int32_t x = minX; x <= maxX; x++)
+			{
+				const int32_t dx = x - cellX;
+
+				if ((dx * dx + dz * dz) > radiusSquared)
 				{
-				case cISC4LandValueSimulator::LandValueType::Low:
-					landValueDescription = "Low";
-					break;
-				case cISC4LandValueSimulator::LandValueType::Medium:
-					landValueDescription = "Medium";
-					break;
-				case cISC4LandValueSimulator::LandValueType::High:
-					landValueDescription = "High";
-					break;
+					continue;
 				}
 
-				int8_t mayorRating = GetSimGridCellValue(
-					spAuraSimulator->GetAuraGrid(),
-					cellX,
-					cellZ);
-
 				int32_t airPollution = 0;
 				int32_t waterPollution = 0;
 				int32_t garbagePollution = 0;
 
-				spPollutionSimulator->GetAirValue(cellX, cellZ, airPollution);
-				spPollutionSimulator->GetWaterValue(cellX, cellZ, waterPollution);
-				spPollutionSimulator->GetGarbageValue(cellX, cellZ, garbagePollution);
-				bool radioactive = spPollutionSimulator->IsRadioactive(cellX, cellZ);
-
-				result = RealRZStringSprintf(
-					rzStringThisPtr,
-					"x=%f y=%f z=%f\ncell x=%d cell z=%d flam=%u\n"
-					"land value %u:%u (%s) mayor rating=%d\n"
-					"pollution: air=%d water=%d garbage=%d rad?=%d",
-					x,
-					y,
-					z,
-					cellX,
-					cellZ,
-					flammability,
-					intrinsicLandValue,
-					totalLandValue,
-					landValueDescription,
-					mayorRating,
-					airPollution,
-					waterPollution,
-					garbagePollution,
-					radioactive);
+				spPollutionSimulator->GetAirValue(x, z, airPollution);
+				spPollutionSimulator->GetWaterValue(x, z, waterPollution);
+				spPollutionSimulator->GetGarbageValue(x, z, garbagePollution);
+
+				sAggregateQueryValues[AggregateQueryMetricAirPollution].push_back(airPollution);
+				sAggregateQueryValues[AggregateQueryMetricWaterPollution].push_back(waterPollution);
+				sAggregateQueryValues[AggregateQueryMetricGarbagePollution].push_back(garbagePollution);
+				sAggregateQueryValues[AggregateQueryMetricLandValue].push_back(spLandValueSimulator->GetLandValue(x, z));
+				sAggregateQueryValues[AggregateQueryMetricFlammability].push_back(GetSimGridCellValue(pFlammabilityGrid, x, z));
+
+				if (pAuraGrid)
+				{
+					sAggregateQueryValues[AggregateQueryMetricMayorRating].push_back(GetSimGridCellValue(pAuraGrid, x, z));
+				}
 			}
 		}
-		else
+
+		result.cellCount = static_cast<uint32_t>(sAggregateQueryValues[AggregateQueryMetricAirPollution].size());
+
+		for (size_t i = 0; i < AggregateQueryMetricCount; i++)
 		{
-			result = RealRZStringSprintf(
-				rzStringThisPtr,
+			std::vector<int32_t>& values = sAggregateQueryValues[i];
+
+			result.statistics[i] = GridReduction::Compute(values.data(), values.size());
+		}
+	}
+
+	const CachedAggregateStatistics& GetAggregateStatistics(const TerrainQueryCellInfo& cellInfo)
+	{
+		const uint32_t epoch = SimulationEpoch::Get();
+		const uint32_t simDay = QueryToolHelpers::GetSimDayNumber();
+		const int32_t radius = sAggregateQueryRadius;
+
+		if (sCachedAggregate.cellX != cellInfo.cellX
+			|| sCachedAggregate.cellZ != cellInfo.cellZ
+			|| sCachedAggregate.epoch != epoch
+			|| sCachedAggregate.simDay != simDay
+			|| sCachedAggregate.radius != radius)
+		{
+			ComputeAggregateStatistics(cellInfo.cellX, cellInfo.cellZ, radius, sCachedAggregate);
+
+			sCachedAggregate.cellX = cellInfo.cellX;
+			sCachedAggregate.cellZ = cellInfo.cellZ;
+			sCachedAggregate.epoch = epoch;
+			sCachedAggregate.simDay = simDay;
+			sCachedAggregate.radius = radius;
+		}
+
+		return sCachedAggregate;
+	}
+
+	void SetAggregateToolTip(const TerrainQueryCellInfo& cellInfo, cIGZString& text)
+	{
+		const CachedAggregateStatistics& aggregate = GetAggregateStatistics(cellInfo);
+
+		text.Sprintf(
+			"x=%f y=%f z=%f\ncell x=%d cell z=%d radius=%d cells=%u\n",
+			cellInfo.x,
+			cellInfo.y,
+			cellInfo.z,
+			cellInfo.cellX,
+			cellInfo.cellZ,
+			aggregate.radius,
+			aggregate.cellCount);
+
+		for (size_t i = 0; i < AggregateQueryMetricCount; i++)
+		{
+			const GridStatistics& statistics = aggregate.statistics[i];
+
+			if (statistics.count > 0)
+			{
+				GZStringUtil::AppendLineFormatted(
+					text,
+					"%s: min=%d max=%d mean=%.1f p50=%d p90=%d",
+					AggregateQueryMetricNames[i],
+					statistics.minimum,
+					statistics.maximum,
+					statistics.mean,
+					statistics.median,
+					statistics.percentile90);
+			}
+		}
+	}
+
+	void SetDefaultToolTip(const TerrainQueryCellInfo& cellInfo, cIGZString& text)
+	{
+		const ModifierKeys modifiers = static_cast<ModifierKeys>(cellInfo.modifierKeys);
+
+		if (!cellInfo.hasSimulationData)
+		{
+			text.Sprintf(
 				"x=%f y=%f z=%f\ncell x=%d cell z=%d",
-				x,
-				y,
-				z,
-				cellX,
-				cellZ);
+				cellInfo.x,
+				cellInfo.y,
+				cellInfo.z,
+				cellInfo.cellX,
+				cellInfo.cellZ);
+		}
+		else if (modifiers == ModifierKeys::None
+			|| (modifiers & ModifierKeys::ControlAltShift) == ModifierKeys::ControlAltShift)
+		{
+			// Show the standard query with the cell moisture added.
+			// This info is also appended to the end of the Control + Alt + Shift advanced/debug
+			// queries, so it need to be fairly short.
+
+			text.Sprintf(
+				"x=%f y=%f z=%f\ncell x=%d cell z=%d cell moisture=%d",
+				cellInfo.x,
+				cellInfo.y,
+				cellInfo.z,
+				cellInfo.cellX,
+				cellInfo.cellZ,
+				cellInfo.moisture);
 		}
+		else if ((modifiers & ModifierKeys::ControlAltShift) == ModifierKeys::Alt)
+		{
+			// Pressing the Alt key will show the humidity and ambient wind information, this data appears
+			// to be for the entire tile instead of varying per-cell.
+
+			text.Sprintf(
+				"x=%f y=%f z=%f\ncell x=%d cell z=%d cell humidity=%f\n"
+				"ambient wind speed=%f\nambient wind direction[0]=%f\nambient wind direction[1]=%f",
+				cellInfo.x,
+				cellInfo.y,
+				cellInfo.z,
+				cellInfo.cellX,
+				cellInfo.cellZ,
+				cellInfo.humidity,
+				cellInfo.ambientWindSpeed,
+				cellInfo.ambientWindDirectionX,
+				cellInfo.ambientWindDirectionY);
+		}
+		else if ((modifiers & ModifierKeys::ControlAltShift) == ModifierKeys::Control)
+		{
+			// Pressing the Control key will show the flammability, land value, and pollution.
+			// Our land value fields use the same order as SC4's advanced/debug query.
+
+			text.Sprintf(
+				"x=%f y=%f z=%f\ncell x=%d cell z=%d flam=%u\n"
+				"land value %u:%u (%s) mayor rating=%d\n"
+				"pollution: air=%d water=%d garbage=%d rad?=%d",
+				cellInfo.x,
+				cellInfo.y,
+				cellInfo.z,
+				cellInfo.cellX,
+				cellInfo.cellZ,
+				cellInfo.flammability,
+				cellInfo.intrinsicLandValue,
+				cellInfo.totalLandValue,
+				GetLandValueTypeDescription(cellInfo.landValueType),
+				cellInfo.mayorRating,
+				cellInfo.airPollution,
+				cellInfo.waterPollution,
+				cellInfo.garbagePollution,
+				cellInfo.radioactive);
+		}
+		else if ((modifiers & ModifierKeys::ControlAltShift) == ModifierKeys::Shift && spCity)
+		{
+			// Pressing the Shift key will show the pollution, land value, flammability and
+			// mayor rating statistics of the cells around the cursor.
 
-		return result;
+			SetAggregateToolTip(cellInfo, text);
+		}
+	}
+
+	int32_t HookedTerrainQuerySprintf(void* rzStringThisPtr, const char* format, ...)
+	{
+		HookTrace::Scope traceScope("HookedTerrainQuerySprintf");
+
+		// Unpack the arguments that were passed to the function.
+
+		va_list args;
+		va_start(args, format);
+
+		TerrainQueryCellInfo cellInfo{};
+		cellInfo.size = sizeof(TerrainQueryCellInfo);
+		cellInfo.x = static_cast<float>(va_arg(args, double));
+		cellInfo.y = static_cast<float>(va_arg(args, double));
+		cellInfo.z = static_cast<float>(va_arg(args, double));
+		cellInfo.cellX = va_arg(args, int32_t);
+		cellInfo.cellZ = va_arg(args, int32_t);
+
+		va_end(args);
+
+		cellInfo.modifierKeys = static_cast<uint32_t>(GetActiveModifierKeys());
+
+		if (spFlammabilitySimulator && spLandValueSimulator && spPollutionSimulator && spWeatherSimulator)
+		{
+			GetCellSimulationData(cellInfo);
+		}
+
+		cRZBaseString text;
+
+		if (!spTerrainQueryToolTipHookServer
+			|| !spTerrainQueryToolTipHookServer->HasCustomToolTipSubscribers()
+			|| !spTerrainQueryToolTipHookServer->SendCustomToolTipMessage(cellInfo, text))
+		{
+			SetDefaultToolTip(cellInfo, text);
+
+			if (spTerrainQueryToolTipHookServer && spTerrainQueryToolTipHookServer->HasAppendToolTipSubscribers())
+			{
+				spTerrainQueryToolTipHookServer->SendAppendToolTipMessage(cellInfo, text);
+			}
+		}
+
+		// The game's string is written with the original function, so that its
+		// memory is managed by the game.
+		return RealRZStringSprintf(rzStringThisPtr, "%s", text.ToChar());
 	}
 }
 
-void TerrainQueryHooks::Install()
+void TerrainQueryHooks::Install(const ISettings& settings)
 {
+	sAggregateQueryRadius = static_cast<int32_t>(std::clamp<uint32_t>(settings.TerrainQueryAggregateRadius(), 1, 32));
+
+
 	Patcher::InstallCallHook(0x4D7335, &HookedTerrainQuerySprintf);
 }
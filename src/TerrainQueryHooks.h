@@ -20,8 +20,9 @@
  */
 
 #pragma once
+#include "ISettings.h"
 
 namespace TerrainQueryHooks
 {
-	void Install();
+	void Install(const ISettings& settings);
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TerrainQueryToolTipHookServer.h"
+#include "cITerrainQueryCustomToolTipHookTarget.h"
+#include "cITerrainQueryToolTipAppendTextHookTarget.h"
+#include "cRZBaseString.h"
+#include "GZStringUtil.h"
+#include "SubscriberStatistics.h"
+#include "TerrainQueryCellInfo.h"
+
+static constexpr const char* CustomToolTipHookName = "TerrainQueryToolTipHookServer custom tool tip hook";
+static constexpr const char* AppendToolTipHookName = "TerrainQueryToolTipHookServer append tool tip hook";
+
+TerrainQueryToolTipHookServer::TerrainQueryToolTipHookServer()
+	: refCount(0)
+{
+}
+
+bool TerrainQueryToolTipHookServer::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cITerrainQueryToolTipHookServer)
+	{
+		*ppvObj = static_cast<cITerrainQueryToolTipHookServer*>(this);
+		AddRef();
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+		return true;
+	}
+
+	*ppvObj = nullptr;
+	return false;
+}
+
+uint32_t TerrainQueryToolTipHookServer::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t TerrainQueryToolTipHookServer::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+bool TerrainQueryToolTipHookServer::HasCustomToolTipSubscribers() const
+{
+	return customToolTipHookSubscribers.size() > 0;
+}
+
+bool TerrainQueryToolTipHookServer::SendCustomToolTipMessage(
+	const TerrainQueryCellInfo& cellInfo,
+	cIGZString& text)
+{
+	bool tooltipHandled = false;
+
+	size_t subscriberCount = customToolTipHookSubscribers.size();
+	if (subscriberCount > 0)
+	{
+		for (cITerrainQueryCustomToolTipHookTarget* pTarget : customToolTipHookSubscribers)
+		{
+			cITerrainQueryCustomToolTipHookTarget* localTarget = pTarget;
+
+			if (localTarget)
+			{
+				SubscriberStatistics::ScopedCall call(CustomToolTipHookName, localTarget);
+
+				if (!call.IsSkipped() && localTarget->ProcessToolTip(
+					cellInfo,
+					text))
+				{
+					tooltipHandled = true;
+					break;
+				}
+			}
+		}
+	}
+
+	return tooltipHandled;
+}
+
+bool TerrainQueryToolTipHookServer::HasAppendToolTipSubscribers() const
+{
+	return appendToolTipHookSubscribers.size() > 0;
+}
+
+void TerrainQueryToolTipHookServer::SendAppendToolTipMessage(const TerrainQueryCellInfo& cellInfo, cIGZString& destination)
+{
+	size_t subscriberCount = appendToolTipHookSubscribers.size();
+	if (subscriberCount > 0)
+	{
+		for (cITerrainQueryToolTipAppendTextHookTarget* pTarget : appendToolTipHookSubscribers)
+		{
+			cITerrainQueryToolTipAppendTextHookTarget* localTarget = pTarget;
+
+			if (localTarget)
+			{
+				SubscriberStatistics::ScopedCall call(AppendToolTipHookName, localTarget);
+				cRZBaseString text;
+
+				if (!call.IsSkipped() && localTarget->AppendQueryToolTipText(
+					cellInfo,
+					text))
+				{
+					// The default terrain tool tip does not end with a new line, the appended
+					// text must start on its own line.
+					const uint32_t destinationLength = destination.Strlen();
+
+					if (destinationLength > 0 && destination.ToChar()[destinationLength - 1] != '\n')
+					{
+						destination.Append("\n", 1);
+					}
+
+					GZStringUtil::AppendLine(text, destination);
+				}
+			}
+		}
+	}
+}
+
+bool TerrainQueryToolTipHookServer::AddNotification(cITerrainQueryCustomToolTipHookTarget* target)
+{
+	return AddNotification(target, QueryHookDefaultPriority);
+}
+
+bool TerrainQueryToolTipHookServer::AddNotification(cITerrainQueryCustomToolTipHookTarget* target, int32_t priority)
+{
+	return customToolTipHookSubscribers.Add(target, priority);
+}
+
+bool TerrainQueryToolTipHookServer::RemoveNotification(cITerrainQueryCustomToolTipHookTarget* target)
+{
+	return customToolTipHookSubscribers.Remove(target);
+}
+
+bool TerrainQueryToolTipHookServer::AddNotification(cITerrainQueryToolTipAppendTextHookTarget* target)
+{
+	return AddNotification(target, QueryHookDefaultPriority);
+}
+
+bool TerrainQueryToolTipHookServer::AddNotification(cITerrainQueryToolTipAppendTextHookTarget* target, int32_t priority)
+{
+	return appendToolTipHookSubscribers.Add(target, priority);
+}
+
+bool TerrainQueryToolTipHookServer::RemoveNotification(cITerrainQueryToolTipAppendTextHookTarget* target)
+{
+	return appendToolTipHookSubscribers.Remove(target);
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cITerrainQueryToolTipHookServer.h"
+#include "PrioritizedSubscriberList.h"
+
+class cIGZString;
+struct TerrainQueryCellInfo;
+
+class TerrainQueryToolTipHookServer : public cITerrainQueryToolTipHookServer
+{
+public:
+	TerrainQueryToolTipHookServer();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool HasCustomToolTipSubscribers() const;
+
+	/**
+	 * @brief Sends the custom tool tip processing message to subscribers. Stops after the first
+	 * subscriber sets a custom tool tip.
+	 * @param cellInfo The position and simulation data of the cell that is being queried.
+	 * @param text The tool tip message.
+	 * @return true if a custom tool tip was set; otherwise, false to show the default tool tip.
+	 */
+	bool SendCustomToolTipMessage(
+		const TerrainQueryCellInfo& cellInfo,
+		cIGZString& text);
+
+	bool HasAppendToolTipSubscribers() const;
+
+	/**
+	 * @brief Sends the append tool tip processing message to subscribers.
+	 * @param cellInfo The position and simulation data of the cell that is being queried.
+	 * @param destination The string that should be appended to.
+	 */
+	void SendAppendToolTipMessage(
+		const TerrainQueryCellInfo& cellInfo,
+		cIGZString& destination);
+
+	bool AddNotification(cITerrainQueryCustomToolTipHookTarget* target) override;
+	bool AddNotification(cITerrainQueryCustomToolTipHookTarget* target, int32_t priority) override;
+	bool RemoveNotification(cITerrainQueryCustomToolTipHookTarget* target) override;
+
+	bool AddNotification(cITerrainQueryToolTipAppendTextHookTarget* target) override;
+	bool AddNotification(cITerrainQueryToolTipAppendTextHookTarget* target, int32_t priority) override;
+	bool RemoveNotification(cITerrainQueryToolTipAppendTextHookTarget* target) override;
+
+private:
+	uint32_t refCount;
+	PrioritizedSubscriberList<cITerrainQueryCustomToolTipHookTarget> customToolTipHookSubscribers;
+	PrioritizedSubscriberList<cITerrainQueryToolTipAppendTextHookTarget> appendToolTipHookSubscribers;
+};
+
@@ -0,0 +1,195 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ToolTipCache.h"
+#include "QueryToolHelpers.h"
+#include "SimulationEpoch.h"
+#include "cIGZString.h"
+#include "cISC4Occupant.h"
+#include "cRZAutoRefCount.h"
+
+#include <array>
+#include <string>
+#include <utility>
+
+namespace
+{
+	struct CacheEntry
+	{
+		cRZAutoRefCount<cISC4Occupant> occupant;
+		bool debugQuery;
+		uint32_t epoch;
+		uint32_t simDay;
+		std::string title;
+		std::string text;
+		uint32_t backgroundImageIID;
+		uint32_t meterImageIID;
+		float meterPercentage;
+
+		CacheEntry()
+			: occupant(),
+			  debugQuery(false),
+			  epoch(0),
+			  simDay(0),
+			  title(),
+			  text(),
+			  backgroundImageIID(0),
+			  meterImageIID(0),
+			  meterPercentage(0.0f)
+		{
+		}
+	};
+
+	// The cursor only rests on one occupant at a time, a few entries are enough to
+	// cover moving back and forth between neighboring occupants.
+	// The entries are ordered from the most to the least recently used.
+	std::array<CacheEntry, 4> sEntries;
+
+	void Reset(CacheEntry& entry)
+	{
+		entry.occupant = nullptr;
+		entry.debugQuery = false;
+		entry.epoch = 0;
+		entry.simDay = 0;
+		entry.title.clear();
+		entry.text.clear();
+		entry.backgroundImageIID = 0;
+		entry.meterImageIID = 0;
+		entry.meterPercentage = 0.0f;
+	}
+
+	void MoveToFront(size_t index)
+	{
+		for (size_t i = index; i > 0; i--)
+		{
+			std::swap(sEntries[i], sEntries[i - 1]);
+		}
+	}
+}
+
+bool ToolTipCache::TryGet(cISC4Occupant* pOccupant, bool debugQuery, ToolTipInfo& destination)
+{
+	if (!pOccupant)
+	{
+		return false;
+	}
+
+	const uint32_t epoch = SimulationEpoch::Get();
+	const uint32_t simDay = QueryToolHelpers::GetSimDayNumber();
+
+	for (size_t i = 0; i < sEntries.size(); i++)
+	{
+		const CacheEntry& entry = sEntries[i];
+
+		if (static_cast<cISC4Occupant*>(entry.occupant) == pOccupant
+			&& entry.debugQuery == debugQuery
+			&& entry.epoch == epoch
+			&& entry.simDay == simDay)
+		{
+			destination.title.FromChar(entry.title.data(), static_cast<uint32_t>(entry.title.size()));
+			destination.text.FromChar(entry.text.data(), static_cast<uint32_t>(entry.text.size()));
+			destination.backgroundImageIID = entry.backgroundImageIID;
+			destination.meterImageIID = entry.meterImageIID;
+			destination.meterPercentage = entry.meterPercentage;
+
+			MoveToFront(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ToolTipCache::TryGet(cISC4Occupant* pOccupant, bool debugQuery, cIGZString& title, cIGZString& text)
+{
+	uint32_t backgroundImageIID = 0;
+	uint32_t meterImageIID = 0;
+	float meterPercentage = 0.0f;
+
+	ToolTipInfo destination{ title, text, backgroundImageIID, meterImageIID, meterPercentage };
+
+	return TryGet(pOccupant, debugQuery, destination);
+}
+
+void ToolTipCache::Add(cISC4Occupant* pOccupant, bool debugQuery, const ToolTipInfo& info)
+{
+	if (!pOccupant)
+	{
+		return;
+	}
+
+	// Reuse the entry of the same occupant and debug query state if there is one,
+	// otherwise the least recently used entry is replaced.
+	size_t index = sEntries.size() - 1;
+
+	for (size_t i = 0; i < sEntries.size(); i++)
+	{
+		if (static_cast<cISC4Occupant*>(sEntries[i].occupant) == pOccupant && sEntries[i].debugQuery == debugQuery)
+		{
+			index = i;
+			break;
+		}
+	}
+
+	CacheEntry& entry = sEntries[index];
+
+	entry.occupant = pOccupant;
+	entry.debugQuery = debugQuery;
+	entry.epoch = SimulationEpoch::Get();
+	entry.simDay = QueryToolHelpers::GetSimDayNumber();
+	entry.title.assign(info.title.Data(), info.title.Strlen());
+	entry.text.assign(info.text.Data(), info.text.Strlen());
+	entry.backgroundImageIID = info.backgroundImageIID;
+	entry.meterImageIID = info.meterImageIID;
+	entry.meterPercentage = info.meterPercentage;
+
+	MoveToFront(index);
+}
+
+void ToolTipCache::Add(cISC4Occupant* pOccupant, bool debugQuery, cIGZString& title, cIGZString& text)
+{
+	uint32_t backgroundImageIID = 0;
+	uint32_t meterImageIID = 0;
+	float meterPercentage = 0.0f;
+
+	const ToolTipInfo info{ title, text, backgroundImageIID, meterImageIID, meterPercentage };
+
+	Add(pOccupant, debugQuery, info);
+}
+
+void ToolTipCache::Remove(cISC4Occupant* pOccupant)
+{
+	for (CacheEntry& entry : sEntries)
+	{
+		if (static_cast<cISC4Occupant*>(entry.occupant) == pOccupant)
+		{
+			Reset(entry);
+		}
+	}
+}
+
+void ToolTipCache::Clear()
+{
+	for (CacheEntry& entry : sEntries)
+	{
+		Reset(entry);
+	}
+}
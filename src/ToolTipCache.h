@@ -0,0 +1,90 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+
+class cIGZString;
+class cISC4Occupant;
+
+// A small cache of the most recently displayed query tool tips.
+// The game rebuilds the tool tip every time it is refreshed, even while the cursor
+// rests on the same occupant, so the cached values let the hooks skip the game's tool
+// tip builder and the subscriber dispatch until the occupant, the debug query state or
+// the simulation date changes.
+// The cache holds a reference to each occupant, so it must be cleared before the city
+// is unloaded.
+namespace ToolTipCache
+{
+	struct ToolTipInfo
+	{
+		cIGZString& title;
+		cIGZString& text;
+		uint32_t& backgroundImageIID;
+		uint32_t& meterImageIID;
+		float& meterPercentage;
+	};
+
+	/**
+	 * @brief Copies the cached tool tip of the specified occupant to the destination.
+	 * @param pOccupant The occupant.
+	 * @param debugQuery true if the debug query mode is enabled; otherwise, false.
+	 * @param destination The destination tool tip values.
+	 * @return true if a current tool tip was cached for the occupant; otherwise, false.
+	 */
+	bool TryGet(cISC4Occupant* pOccupant, bool debugQuery, ToolTipInfo& destination);
+
+	/**
+	 * @brief Copies the cached tool tip title and text of the specified occupant.
+	 * This overload is used by the tool tips that do not have a background or meter image.
+	 * @param pOccupant The occupant.
+	 * @param debugQuery true if the debug query mode is enabled; otherwise, false.
+	 * @param title The destination title.
+	 * @param text The destination text.
+	 * @return true if a current tool tip was cached for the occupant; otherwise, false.
+	 */
+	bool TryGet(cISC4Occupant* pOccupant, bool debugQuery, cIGZString& title, cIGZString& text);
+
+	/**
+	 * @brief Adds the tool tip of the specified occupant to the cache.
+	 * @param pOccupant The occupant.
+	 * @param debugQuery true if the debug query mode is enabled; otherwise, false.
+	 * @param info The tool tip values.
+	 */
+	void Add(cISC4Occupant* pOccupant, bool debugQuery, const ToolTipInfo& info);
+
+	/**
+	 * @brief Adds the tool tip title and text of the specified occupant to the cache.
+	 * @param pOccupant The occupant.
+	 * @param debugQuery true if the debug query mode is enabled; otherwise, false.
+	 * @param title The tool tip title.
+	 * @param text The tool tip text.
+	 */
+	void Add(cISC4Occupant* pOccupant, bool debugQuery, cIGZString& title, cIGZString& text);
+
+	/**
+	 * @brief Removes the cached tool tips of the specified occupant.
+	 * @param pOccupant The occupant.
+	 */
+	void Remove(cISC4Occupant* pOccupant);
+
+	void Clear();
+}
@@ -0,0 +1,296 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BuildingOccupantSnapshot.h"
+#include "cISCPropertyHolder.h"
+#include "cISC4City.h"
+#include "cISC4Lot.h"
+#include "cISC4LotConfiguration.h"
+#include "cISC4Occupant.h"
+#include "cISC4TrafficSimulator.h"
+#include "cISC4ZoneManager.h"
+#include "GlobalSC4InterfacePointers.h"
+#include "OccupantUtil.h"
+#include "SC4Vector.h"
+#include <algorithm>
+
+namespace
+{
+	using DeveloperType = cISC4BuildingDevelopmentSimulator::DeveloperType;
+
+	// The developer types that have query variables, the snapshot arrays use the same order.
+	static constexpr std::array<DeveloperType, 12> SnapshotDeveloperTypes =
+	{
+		DeveloperType::ResidentialLowWealth,
+		DeveloperType::ResidentialMediumWealth,
+		DeveloperType::ResidentialHighWealth,
+		DeveloperType::CommercialServicesLowWealth,
+		DeveloperType::CommercialServicesMediumWealth,
+		DeveloperType::CommercialServicesHighWealth,
+		DeveloperType::CommercialOfficeMediumWealth,
+		DeveloperType::CommercialOfficeHighWealth,
+		DeveloperType::IndustrialAgriculture,
+		DeveloperType::IndustrialProcessing,
+		DeveloperType::IndustrialManufacturing,
+		DeveloperType::IndustrialHighTech,
+	};
+
+	bool TryGetDeveloperTypeIndex(DeveloperType type, size_t& index)
+	{
+		for (size_t i = 0; i < SnapshotDeveloperTypes.size(); i++)
+		{
+			if (SnapshotDeveloperTypes[i] == type)
+			{
+				index = i;
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+BuildingOccupantSnapshot::BuildingOccupantSnapshot(cISC4Occupant* pOccupant)
+	: pOccupant(pOccupant),
+	  pPropertyHolder(nullptr),
+	  pLot(nullptr),
+	  buildingOccupant(),
+	  buildingType(0),
+	  populations{},
+	  capacities{},
+	  jobs{},
+	  travelJobs{},
+	  plopped(false),
+	  hasGrowthStage(false),
+	  growthStage(0),
+	  budgetItems(),
+	  budgetCostsByPurpose(),
+	  budgetTotal(0)
+{
+	static_assert(SnapshotDeveloperTypes.size() == DeveloperTypeCount);
+
+	if (pOccupant)
+	{
+		pPropertyHolder = pOccupant->AsPropertyHolder();
+
+		if (pOccupant->QueryInterface(GZIID_cISC4BuildingOccupant, buildingOccupant.AsPPVoid()))
+		{
+			buildingType = buildingOccupant->GetBuildingType();
+		}
+
+		if (spCity)
+		{
+			pLot = OccupantUtil::GetLot(pOccupant, spCity);
+
+			cISC4BudgetSimulator* pBudgetSim = spCity->GetBudgetSimulator();
+
+			if (pBudgetSim)
+			{
+				SC4Vector<cISC4BudgetSimulator::BudgetItem> items;
+
+				if (pBudgetSim->GetBudgetItemInfo(pPropertyHolder, items))
+				{
+					const size_t count = items.size();
+					budgetItems.reserve(count);
+
+					for (size_t i = 0; i < count; i++)
+					{
+						budgetItems.push_back(items[i]);
+					}
+
+					BuildBudgetCostIndex();
+				}
+			}
+		}
+	}
+
+	if (pLot)
+	{
+		for (size_t i = 0; i < SnapshotDeveloperTypes.size(); i++)
+		{
+			const DeveloperType type = SnapshotDeveloperTypes[i];
+
+			populations[i] = pLot->GetPopulation(type);
+			capacities[i] = pLot->GetCapacity(type, true);
+		}
+
+		if (pLot->GetZoneType() == cISC4ZoneManager::ZoneType::Plopped)
+		{
+			plopped = true;
+		}
+		else
+		{
+			cISC4LotConfiguration* pLotConfiguration = pLot->GetLotConfiguration();
+
+			if (pLotConfiguration)
+			{
+				growthStage = pLotConfiguration->GetGrowthStage();
+				hasGrowthStage = true;
+			}
+		}
+
+		// The first item in the lot jobs array is not used by the query variables.
+		std::array<float, 4> lotJobs{};
+
+		if (pLot->GetJobs(lotJobs.data()))
+		{
+			jobs[0] = lotJobs[1];
+			jobs[1] = lotJobs[2];
+			jobs[2] = lotJobs[3];
+		}
+
+		// Industrial lots without their own road access will have an industrial anchor lot
+		// provide road access for their workers.
+		// This internal commuting is invisible to the traffic simulator, so when querying
+		// an industrial anchor lot the number of workers is often higher that what that
+		// lot supports on its own.
+		// We report zero travel jobs for industrial lots without their own road access.
+		if (pLot->GetTravelDesignate() == nullptr)
+		{
+			cISC4TrafficSimulator* pTrafficSim = spCity->GetTrafficSimulator();
+
+			if (pTrafficSim)
+			{
+				for (size_t i = 0; i < travelJobs.size(); i++)
+				{
+					travelJobs[i] = pTrafficSim->GetMaxTripCapacity(pLot->AsPropertyHolder(), static_cast<uint32_t>(i));
+				}
+			}
+		}
+	}
+}
+
+cISC4Occupant* BuildingOccupantSnapshot::GetOccupant() const
+{
+	return pOccupant;
+}
+
+cISCPropertyHolder* BuildingOccupantSnapshot::GetPropertyHolder() const
+{
+	return pPropertyHolder;
+}
+
+cISC4Lot* BuildingOccupantSnapshot::GetLot() const
+{
+	return pLot;
+}
+
+cISC4BuildingOccupant* BuildingOccupantSnapshot::GetBuildingOccupant() const
+{
+	return buildingOccupant;
+}
+
+uint32_t BuildingOccupantSnapshot::GetBuildingType() const
+{
+	return buildingType;
+}
+
+uint16_t BuildingOccupantSnapshot::GetPopulation(DeveloperType type) const
+{
+	size_t index = 0;
+
+	return TryGetDeveloperTypeIndex(type, index) ? populations[index] : 0;
+}
+
+uint16_t BuildingOccupantSnapshot::GetCapacity(DeveloperType type) const
+{
+	size_t index = 0;
+
+	return TryGetDeveloperTypeIndex(type, index) ? capacities[index] : 0;
+}
+
+float BuildingOccupantSnapshot::GetJobs(WealthType type) const
+{
+	return jobs[static_cast<size_t>(type)];
+}
+
+uint32_t BuildingOccupantSnapshot::GetTravelJobs(WealthType type) const
+{
+	return travelJobs[static_cast<size_t>(type)];
+}
+
+bool BuildingOccupantSnapshot::IsPlopped() const
+{
+	return plopped;
+}
+
+bool BuildingOccupantSnapshot::GetGrowthStage(uint8_t& growthStage) const
+{
+	if (hasGrowthStage)
+	{
+		growthStage = this->growthStage;
+		return true;
+	}
+
+	return false;
+}
+
+const std::vector<cISC4BudgetSimulator::BudgetItem>& BuildingOccupantSnapshot::GetBudgetItems() const
+{
+	return budgetItems;
+}
+
+bool BuildingOccupantSnapshot::GetBudgetItemCost(uint32_t purpose, int64_t& cost) const
+{
+	auto it = std::lower_bound(
+		budgetCostsByPurpose.begin(),
+		budgetCostsByPurpose.end(),
+		purpose,
+		[](const std::pair<uint32_t, int64_t>& item, uint32_t value) { return item.first < value; });
+
+	if (it != budgetCostsByPurpose.end() && it->first == purpose)
+	{
+		cost = it->second;
+		return true;
+	}
+
+	return false;
+}
+
+int64_t BuildingOccupantSnapshot::GetBudgetTotal() const
+{
+	return budgetTotal;
+}
+
+void BuildingOccupantSnapshot::BuildBudgetCostIndex()
+{
+	budgetCostsByPurpose.reserve(budgetItems.size());
+
+	for (const cISC4BudgetSimulator::BudgetItem& item : budgetItems)
+	{
+		budgetCostsByPurpose.emplace_back(item.purpose, item.cost);
+		budgetTotal += item.cost;
+	}
+
+	// A stable sort is used so that the first budget item with a specific purpose
+	// is kept if there are duplicates, this matches the game's GetBudgetItemForPurpose.
+	std::stable_sort(
+		budgetCostsByPurpose.begin(),
+		budgetCostsByPurpose.end(),
+		[](const std::pair<uint32_t, int64_t>& a, const std::pair<uint32_t, int64_t>& b) { return a.first < b.first; });
+
+	budgetCostsByPurpose.erase(
+		std::unique(
+			budgetCostsByPurpose.begin(),
+			budgetCostsByPurpose.end(),
+			[](const std::pair<uint32_t, int64_t>& a, const std::pair<uint32_t, int64_t>& b) { return a.first == b.first; }),
+		budgetCostsByPurpose.end());
+}
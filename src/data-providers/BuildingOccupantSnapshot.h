@@ -0,0 +1,105 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cISC4BudgetSimulator.h"
+#include "cISC4BuildingDevelopmentSimulator.h"
+#include "cISC4BuildingOccupant.h"
+#include "cRZAutoRefCount.h"
+#include <array>
+#include <utility>
+#include <vector>
+
+class cISCPropertyHolder;
+class cISC4Lot;
+class cISC4Occupant;
+
+/**
+ * @brief The lot and building data that is read by the building query variables.
+ *
+ * The snapshot is created before the query dialog is shown and it is not modified
+ * after that, this allows the query variables to share a single set of lot and
+ * building lookups instead of each variable repeating them.
+ */
+class BuildingOccupantSnapshot
+{
+public:
+	using DeveloperType = cISC4BuildingDevelopmentSimulator::DeveloperType;
+
+	enum class WealthType : uint32_t
+	{
+		Low = 0,
+		Medium,
+		High
+	};
+
+	explicit BuildingOccupantSnapshot(cISC4Occupant* pOccupant);
+
+	BuildingOccupantSnapshot(const BuildingOccupantSnapshot&) = delete;
+	BuildingOccupantSnapshot& operator=(const BuildingOccupantSnapshot&) = delete;
+
+	cISC4Occupant* GetOccupant() const;
+	cISCPropertyHolder* GetPropertyHolder() const;
+	cISC4Lot* GetLot() const;
+	cISC4BuildingOccupant* GetBuildingOccupant() const;
+	uint32_t GetBuildingType() const;
+
+	uint16_t GetPopulation(DeveloperType type) const;
+	uint16_t GetCapacity(DeveloperType type) const;
+
+	float GetJobs(WealthType type) const;
+	uint32_t GetTravelJobs(WealthType type) const;
+
+	bool IsPlopped() const;
+	/**
+	 * @brief Gets the growth stage of the lot configuration.
+	 * @param growthStage On success, receives the growth stage.
+	 * @return True if the lot has a growth stage; otherwise, false.
+	 */
+	bool GetGrowthStage(uint8_t& growthStage) const;
+
+	const std::vector<cISC4BudgetSimulator::BudgetItem>& GetBudgetItems() const;
+	bool GetBudgetItemCost(uint32_t purpose, int64_t& cost) const;
+	int64_t GetBudgetTotal() const;
+
+private:
+	void BuildBudgetCostIndex();
+
+	static constexpr size_t DeveloperTypeCount = 12;
+	static constexpr size_t WealthTypeCount = 3;
+
+	cISC4Occupant* pOccupant;
+	cISCPropertyHolder* pPropertyHolder;
+	cISC4Lot* pLot;
+	cRZAutoRefCount<cISC4BuildingOccupant> buildingOccupant;
+	uint32_t buildingType;
+	std::array<uint16_t, DeveloperTypeCount> populations;
+	std::array<uint16_t, DeveloperTypeCount> capacities;
+	std::array<float, WealthTypeCount> jobs;
+	std::array<uint32_t, WealthTypeCount> travelJobs;
+	bool plopped;
+	bool hasGrowthStage;
+	uint8_t growthStage;
+	std::vector<cISC4BudgetSimulator::BudgetItem> budgetItems;
+	// The budget item costs sorted by purpose id.
+	std::vector<std::pair<uint32_t, int64_t>> budgetCostsByPurpose;
+	int64_t budgetTotal;
+};
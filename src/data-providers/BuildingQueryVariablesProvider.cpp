@@ -20,15 +20,22 @@
  */
 
 #include "BuildingQueryVariablesProvider.h"
+#include "BuildingOccupantSnapshot.h"
 #include "BuildingPluginInfo.h"
-#include "cIBuildingStyleInfo2.h"
+#include "BuildingStyleCache.h"
+#include "BuildingQueryVariableRegistry.h"
+#include "BuildingTypeTokenCache.h"
 #include "cIBuildingQueryHookServer.h"
 #include "DebugUtil.h"
 #include "frozen/string.h"
 #include "frozen/unordered_map.h"
+#include "GlobalHookServerPointers.h"
 #include "GZStringUtil.h"
+#include "LocaleNumberFormatter.h"
 #include "Logger.h"
-#include "OccupantUtil.h"
+#include "OccupantSnapshotCache.h"
+#include "PropertyNameDictionary.h"
+#include "QueryExpression.h"
 #include "cGZPersistResourceKey.h"
 #include "cIGZLanguageManager.h"
 #include "cIGZLanguageUtility.h"
@@ -46,12 +53,10 @@
 #include "cISC4BuildingDevelopmentSimulator.h"
 #include "cISC4City.h"
 #include "cISC4Lot.h"
-#include "cISC4LotConfiguration.h"
 #include "cISC4LotManager.h"
 #include "cISC4MySim.h"
 #include "cISC4MySimAgentSimulator.h"
 #include "cISC4Occupant.h"
-#include "cISC4TrafficSimulator.h"
 #include "cRZAutoRefCount.h"
 #include "cRZBaseString.h"
 #include "cS3DVector3.h"
@@ -59,17 +64,23 @@
 #include "SCPropertyUtil.h"
 #include "SC4String.h"
 #include "SC4Vector.h"
+#include "SimulationEpoch.h"
 #include "StringViewUtil.h"
 
 #include <algorithm>
 #include <array>
 #include <any>
 #include <cctype>
+#include <cstdio>
+#include <chrono>
+#include <charconv>
 #include <filesystem>
 #include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 using namespace std::string_view_literals;
 
@@ -92,32 +103,42 @@ namespace
 
 	struct UnknownTokenContext
 	{
-		cISC4Occupant* pOccupant;
+		const BuildingOccupantSnapshot* pSnapshot;
+		BuildingTypeTokenCache* pBuildingTypeTokenCache;
+		BuildingStyleCache* pBuildingStyleCache;
 
 		UnknownTokenContext()
-			: pOccupant(nullptr)
+			: pSnapshot(nullptr),
+			  pBuildingTypeTokenCache(nullptr),
+			  pBuildingStyleCache(nullptr)
 		{
 		}
 	};
 
-	static constexpr std::array<std::pair<uint32_t, std::string_view>, 4> MaxisBuildingStyles =
+	const BuildingOccupantSnapshot* GetOccupantSnapshot(const UnknownTokenContext* context)
 	{
-		std::pair(0x2000, "Chicago 1890"),
-		std::pair(0x2001, "New York 1940"),
-		std::pair(0x2002, "Houston 1990"),
-		std::pair(0x2003, "Euro-Contemporary"),
-	};
-
-	cISC4Lot* GetOccupantLot(const UnknownTokenContext* context)
-	{
-		cISC4Lot* pLot = nullptr;
+		const BuildingOccupantSnapshot* pSnapshot = nullptr;
 
-		if (context && context->pOccupant)
+		if (context && context->pSnapshot && context->pSnapshot->GetOccupant())
 		{
-			pLot = OccupantUtil::GetLot(context->pOccupant, spCity);
+			pSnapshot = context->pSnapshot;
 		}
 
-		return pLot;
+		return pSnapshot;
+	}
+
+	cISC4Occupant* GetOccupant(const UnknownTokenContext* context)
+	{
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		return pSnapshot ? pSnapshot->GetOccupant() : nullptr;
+	}
+
+	cISC4Lot* GetOccupantLot(const UnknownTokenContext* context)
+	{
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		return pSnapshot ? pSnapshot->GetLot() : nullptr;
 	}
 
 	enum class NumberType
@@ -141,22 +162,19 @@ namespace
 		cIGZString& destination,
 		NumberType type = NumberType::Number)
 	{
-		bool result = false;
+		// The formatter captures the game's number format once per language, this avoids
+		// calling into the game's language utility for each of the numeric tokens.
+		static LocaleNumberFormatter sNumberFormatter;
 
-		cIGZLanguageUtility* pLU = spLanguageManager->GetLanguageUtility(0);
+		bool result = false;
 
-		if (pLU)
+		if (type == NumberType::Number)
 		{
-			if (type == NumberType::Number)
-			{
-				result = pLU->MakeNumberString(number, destination);
-			}
-			else if (type == NumberType::Money)
-			{
-				static const cRZBaseString currencySymbol(SECTION_SYMBOL_UTF8);
-
-				result = pLU->MakeMoneyString(number, destination, &currencySymbol);
-			}
+			result = sNumberFormatter.MakeNumberString(number, destination);
+		}
+		else if (type == NumberType::Money)
+		{
+			result = sNumberFormatter.MakeMoneyString(number, destination);
 		}
 
 		return result;
@@ -188,51 +206,46 @@ namespace
 	{
 		int64_t value = 0;
 
-		if (context && spCity && context->pOccupant)
-		{
-			cISC4BudgetSimulator* pBudgetSim = spCity->GetBudgetSimulator();
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-			if (pBudgetSim)
+		if (pSnapshot)
+		{
+			// The built-in budget departments that use per-building variable funding
+			// can have up to two have two different purpose values: Capacity and coverage.
+			//
+			// Capacity is used for things like the number of patients a Health building can support or
+			// the coverage radius of a Fire/Police station.
+			// Coverage is the coverage radius for Education and Health buildings (School Bus/Ambulance).
+			//
+			// The first budget item in the building's item order that has a matching purpose
+			// and a non-zero cost is used.
+			const std::vector<cISC4BudgetSimulator::BudgetItem>& budgetItems = pSnapshot->GetBudgetItems();
+
+			for (size_t i = 0; i < budgetItems.size() && value == 0; i++)
 			{
-				SC4Vector<cISC4BudgetSimulator::BudgetItem> budgetItems;
+				const cISC4BudgetSimulator::BudgetItem& item = budgetItems[i];
 
-				if (pBudgetSim->GetBudgetItemInfo(context->pOccupant->AsPropertyHolder(), budgetItems))
+				if (type == BuildingFundingType::Capacity)
 				{
-					const size_t count = budgetItems.size();
-
-					for (size_t i = 0; i < count && value == 0; i++)
+					switch (item.purpose)
 					{
-						const cISC4BudgetSimulator::BudgetItem& item = budgetItems[i];
-
-						// The built-in budget departments that use per-building variable funding
-						// can have up to two have two different purpose values: Capacity and coverage.
-						//
-						// Capacity is used for things like the number of patients a Health building can support or
-						// the coverage radius of a Fire/Police station.
-						// Coverage is the coverage radius for Education and Health buildings (School Bus/Ambulance).
-						if (type == BuildingFundingType::Capacity)
-						{
-							switch (item.purpose)
-							{
-							case 0xEA5654B6: // Education Staff
-							case 0xEA567BC3: // Fire Protection
-							case 0xCA565486: // Health Staff
-							case 0x0A567BAA: // Police Protection
-							case 0xCA58E540: // Power Production
-								value = item.cost;
-								break;
-							}
-						}
-						else // Coverage
-						{
-							switch (item.purpose)
-							{
-							case 0x4A5654BA: // Education Coverage
-							case 0xEA56549E: // Health Coverage
-								value = item.cost;
-								break;
-							}
-						}
+					case 0xEA5654B6: // Education Staff
+					case 0xEA567BC3: // Fire Protection
+					case 0xCA565486: // Health Staff
+					case 0x0A567BAA: // Police Protection
+					case 0xCA58E540: // Power Production
+						value = item.cost;
+						break;
+					}
+				}
+				else // Coverage
+				{
+					switch (item.purpose)
+					{
+					case 0x4A5654BA: // Education Coverage
+					case 0xEA56549E: // Health Coverage
+						value = item.cost;
+						break;
 					}
 				}
 			}
@@ -264,57 +277,66 @@ namespace
 		}
 	}
 
-	bool GetBuildingStylesToken(
+	bool GetBudgetPurposeTypeCostAllToken(
 		const UnknownTokenContext* context,
 		cIGZString& outReplacement,
 		TokenSeparatorType type)
 	{
-		bool result = false;
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-		if (context && context->pOccupant)
+		if (pSnapshot)
 		{
 			const std::string_view separator = GetTokenSeparator(type);
+			const std::vector<cISC4BudgetSimulator::BudgetItem>& budgetItems = pSnapshot->GetBudgetItems();
 
-			cRZAutoRefCount<cIBuildingStyleInfo2> pBuildingStyleInfo;
-
-			if (RZGetFramework()->GetCOMObject()->GetClassObject(
-				GZCLSID_cIBuildingStyleInfo,
-				GZIID_cIBuildingStyleInfo2,
-				pBuildingStyleInfo.AsPPVoid()))
-			{
-				// If the More Building Styles DLL is installed we check the building's OccupantGroups
-				// for any styles that are present in the Building Style Control.
-				result = pBuildingStyleInfo->GetBuildingStyleNamesEx(
-					context->pOccupant,
-					outReplacement,
-					cRZBaseString(separator.data(), separator.size()));
-			}
-			else
+			for (const cISC4BudgetSimulator::BudgetItem& item : budgetItems)
 			{
-				// If the More Building Styles DLL is not installed we fall back to checking for
-				// the 4 built-in Maxis styles.
-
-				for (size_t i = 0; i < MaxisBuildingStyles.size(); i++)
+				if (outReplacement.Strlen() > 0)
 				{
-					const auto& item = MaxisBuildingStyles[i];
-
-					if (context->pOccupant->IsOccupantGroup(item.first))
-					{
-						outReplacement.Append(item.second.data(), item.second.size());
-						outReplacement.Append(separator.data(), separator.size());
-					}
+					outReplacement.Append(separator.data(), separator.size());
 				}
 
-				// Check that at least one style name has been written to the destination.
-				if (outReplacement.Strlen() > 0)
+				char purposeText[16]{};
+				const int purposeTextLength = std::snprintf(purposeText, sizeof(purposeText), "0x%08x: ", item.purpose);
+
+				cRZBaseString formattedCost;
+
+				if (purposeTextLength <= 0
+					|| !MakeNumberStringForCurrentLanguage(item.cost, formattedCost, NumberType::Money))
 				{
-					// Remove the trailing separator from the last style in the list.
-					outReplacement.Resize(outReplacement.Strlen() - separator.size());
-					result = true;
+					return false;
 				}
+
+				outReplacement.Append(purposeText, static_cast<uint32_t>(purposeTextLength));
+				outReplacement.Append(formattedCost);
 			}
 		}
 
+		if (outReplacement.Strlen() == 0)
+		{
+			outReplacement.FromChar("None");
+		}
+
+		return true;
+	}
+
+	bool GetBuildingStylesToken(
+		const UnknownTokenContext* context,
+		cIGZString& outReplacement,
+		TokenSeparatorType type)
+	{
+		bool result = false;
+
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot && context->pBuildingStyleCache)
+		{
+			result = context->pBuildingStyleCache->AppendStyleNames(
+				pSnapshot->GetOccupant(),
+				GetTokenSeparator(type),
+				outReplacement);
+		}
+
 		if (!result || outReplacement.Strlen() == 0)
 		{
 			outReplacement.FromChar("None");
@@ -328,11 +350,13 @@ namespace
 	{
 		bool result = false;
 
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot)
 		{
-			cRZAutoRefCount<cISC4BuildingOccupant> pBuildingOccupant;
+			cISC4BuildingOccupant* pBuildingOccupant = pSnapshot->GetBuildingOccupant();
 
-			if (context->pOccupant->QueryInterface(GZIID_cISC4BuildingOccupant, pBuildingOccupant.AsPPVoid()))
+			if (pBuildingOccupant)
 			{
 				const cISC4BuildingOccupant::BuildingProfile& profile = pBuildingOccupant->GetBuildingProfile();
 				const cISC4BuildingOccupant::PurposeType purpose = profile.purpose;
@@ -410,18 +434,17 @@ namespace
 	{
 		bool result = false;
 
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot && context->pBuildingStyleCache)
 		{
-			cRZAutoRefCount<cIBuildingStyleInfo2> pBuildingStyleInfo;
+			bool isWallToWall = false;
 
-			if (RZGetFramework()->GetCOMObject()->GetClassObject(
-				GZCLSID_cIBuildingStyleInfo,
-				GZIID_cIBuildingStyleInfo2,
-				pBuildingStyleInfo.AsPPVoid()))
+			if (context->pBuildingStyleCache->TryGetWallToWall(pSnapshot->GetOccupant(), isWallToWall))
 			{
 				// If the More Building Styles DLL is installed we check the if the building is wall to wall.
 				// The output string will be a localized version of Yes or No.
-				if (pBuildingStyleInfo->IsWallToWall(context->pOccupant))
+				if (isWallToWall)
 				{
 					result = GZStringUtil::SetLocalizedStringValue(0xEA5524EB, 0xCA5D4F33, outReplacement);
 				}
@@ -432,10 +455,6 @@ namespace
 			}
 			else
 			{
-				Logger::GetInstance().WriteLine(
-					LogLevel::Error,
-					"Unable to get the building W2W status. Install or update the MoreBuildingStyles DLL."
-					"(https://community.simtropolis.com/files/file/36112-allow-more-building-styles-dll-plugin/).");
 				outReplacement.FromChar("Unknown");
 				result = true;
 			}
@@ -451,11 +470,11 @@ namespace
 	{
 		uint16_t capacity = 0;
 
-		cISC4Lot* pLot = GetOccupantLot(context);
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-		if (pLot)
+		if (pSnapshot)
 		{
-			capacity = pLot->GetCapacity(developerType, true);
+			capacity = pSnapshot->GetCapacity(developerType);
 		}
 
 		return MakeNumberStringForCurrentLanguage(capacity, outReplacement);
@@ -468,11 +487,11 @@ namespace
 	{
 		uint16_t occupancy = 0;
 
-		cISC4Lot* pLot = GetOccupantLot(context);
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-		if (pLot)
+		if (pSnapshot)
 		{
-			occupancy = pLot->GetPopulation(developerType);
+			occupancy = pSnapshot->GetPopulation(developerType);
 		}
 
 		return MakeNumberStringForCurrentLanguage(occupancy, outReplacement);
@@ -480,24 +499,21 @@ namespace
 
 	bool GetGrowthStageToken(UnknownTokenContext* context, cIGZString& outReplacement)
 	{
-		cISC4Lot* pLot = GetOccupantLot(context);
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-		if (pLot)
+		if (pSnapshot)
 		{
-			cISC4ZoneManager::ZoneType zone = pLot->GetZoneType();
-
-			if (zone == cISC4ZoneManager::ZoneType::Plopped)
+			if (pSnapshot->IsPlopped())
 			{
 				outReplacement.FromChar("Plop");
 				return true;
 			}
 			else
 			{
-				cISC4LotConfiguration* pLotConfiguration = pLot->GetLotConfiguration();
+				uint8_t growthStage = 0;
 
-				if (pLotConfiguration)
+				if (pSnapshot->GetGrowthStage(growthStage))
 				{
-					uint8_t growthStage = pLotConfiguration->GetGrowthStage();
 					return MakeNumberStringForCurrentLanguage(growthStage, outReplacement);
 				}
 			}
@@ -507,38 +523,17 @@ namespace
 		return true;
 	}
 
-	enum class JobType
-	{
-		LowWealth = 0,
-		MediumWealth,
-		HighWealth
-	};
+	using JobType = BuildingOccupantSnapshot::WealthType;
 
 	bool GetLotJobCount(UnknownTokenContext* context, cIGZString& outReplacement, JobType type)
 	{
 		float jobCount = 0;
 
-		cISC4Lot* pLot = GetOccupantLot(context);
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-		if (pLot)
+		if (pSnapshot)
 		{
-			std::array<float, 4> jobs{};
-
-			if (pLot->GetJobs(jobs.data()))
-			{
-				switch (type)
-				{
-				case JobType::LowWealth:
-					jobCount = jobs[1];
-					break;
-				case JobType::MediumWealth:
-					jobCount = jobs[2];
-					break;
-				case JobType::HighWealth:
-					jobCount = jobs[3];
-					break;
-				}
-			}
+			jobCount = pSnapshot->GetJobs(type);
 		}
 
 		return MakeNumberStringForCurrentLanguage(lroundf(jobCount), outReplacement);
@@ -548,36 +543,11 @@ namespace
 	{
 		uint32_t travelJobs = 0;
 
-		cISC4Lot* pLot = GetOccupantLot(context);
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-		if (pLot)
+		if (pSnapshot)
 		{
-			// Industrial lots without their own road access will have an industrial anchor lot
-			// provide road access for their workers.
-			// This internal commuting is invisible to the traffic simulator, so when querying
-			// an industrial anchor lot the number of workers is often higher that what that
-			// lot supports on its own.
-			// We report zero travel jobs for industrial lots without their own road access.
-			if (pLot->GetTravelDesignate() == nullptr)
-			{
-				cISC4TrafficSimulator* pTrafficSim = spCity->GetTrafficSimulator();
-
-				if (pTrafficSim)
-				{
-					switch (type)
-					{
-					case JobType::LowWealth:
-						travelJobs = pTrafficSim->GetMaxTripCapacity(pLot->AsPropertyHolder(), 0);
-						break;
-					case JobType::MediumWealth:
-						travelJobs = pTrafficSim->GetMaxTripCapacity(pLot->AsPropertyHolder(), 1);
-						break;
-					case JobType::HighWealth:
-						travelJobs = pTrafficSim->GetMaxTripCapacity(pLot->AsPropertyHolder(), 2);
-						break;
-					}
-				}
-			}
+			travelJobs = pSnapshot->GetTravelJobs(type);
 		}
 
 		return MakeNumberStringForCurrentLanguage(travelJobs, outReplacement);
@@ -587,11 +557,13 @@ namespace
 	{
 		bool result = false;
 
-		if (context && context->pOccupant && spCity)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot && spCity)
 		{
-			cRZAutoRefCount<cISC4BuildingOccupant> pBuildingOccupant;
+			cISC4BuildingOccupant* pBuildingOccupant = pSnapshot->GetBuildingOccupant();
 
-			if (context->pOccupant->QueryInterface(GZIID_cISC4BuildingOccupant, pBuildingOccupant.AsPPVoid()))
+			if (pBuildingOccupant)
 			{
 				cISC4MySimAgentSimulator* pMySimAgentSimulator = spCity->GetMySimAgentSimulator();
 
@@ -619,7 +591,9 @@ namespace
 	{
 		bool result = false;
 
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot)
 		{
 			constexpr uint32_t kWaterSourcePropertyID = 0x48F23A7E;
 
@@ -632,7 +606,7 @@ namespace
 
 			uint8_t waterSource = 0;
 
-			if (SCPropertyUtil::GetPropertyValue(context->pOccupant->AsPropertyHolder(), kWaterSourcePropertyID, waterSource))
+			if (SCPropertyUtil::GetPropertyValue(pSnapshot->GetPropertyHolder(), kWaterSourcePropertyID, waterSource))
 			{
 				switch (static_cast<WaterSource>(waterSource))
 				{
@@ -664,45 +638,65 @@ namespace
 		return result;
 	}
 
+	// The parameters of a parameterized token, these are parsed once when the token is
+	// first seen and reused for every later occurrence of the same token.
+	struct TokenParameters
+	{
+		std::array<uint32_t, 2> values;
+		size_t count;
+
+		TokenParameters()
+			: values{}, count(0)
+		{
+		}
+	};
+
+	bool ParseHexIDParameter(std::string_view const& text, TokenParameters& parameters)
+	{
+		uint32_t value = 0;
+
+		if (!text.empty() && StringViewUtil::TryParse(text, value))
+		{
+			parameters.values[0] = value;
+			parameters.count = 1;
+			return true;
+		}
+
+		return false;
+	}
+
 	bool GetBudgetPurposeTypeCost(
-		std::string_view const& token,
-		std::string_view const& prefix,
+		TokenParameters const& parameters,
 		UnknownTokenContext* context,
 		cIGZString& destination)
 	{
 		int64_t cost = 0;
 
-		if (context && context->pOccupant && spCity)
-		{
-			std::string_view purposeIDHexString;
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-			if (token.length() > prefix.length())
+		if (pSnapshot && parameters.count == 1)
+		{
+			if (!pSnapshot->GetBudgetItemCost(parameters.values[0], cost))
 			{
-				purposeIDHexString = token.substr(prefix.length());
+				cost = 0;
 			}
+		}
 
-			if (!purposeIDHexString.empty())
-			{
-				uint32_t purposeID = 0;
+		return MakeNumberStringForCurrentLanguage(cost, destination, NumberType::Money);
+	}
 
-				if (StringViewUtil::TryParse(purposeIDHexString, purposeID))
-				{
-					cISC4BudgetSimulator* pBudgetSim = spCity->GetBudgetSimulator();
+	bool GetBudgetTotalToken(UnknownTokenContext* context, cIGZString& outReplacement)
+	{
+		int64_t total = 0;
 
-					if (pBudgetSim)
-					{
-						cISC4BudgetSimulator::BudgetItem budgetItem{};
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-						if (pBudgetSim->GetBudgetItemForPurpose(context->pOccupant->AsPropertyHolder(), purposeID, budgetItem))
-						{
-							cost = budgetItem.cost;
-						}
-					}
-				}
-			}
+		if (pSnapshot)
+		{
+			total = pSnapshot->GetBudgetTotal();
 		}
 
-		return MakeNumberStringForCurrentLanguage(cost, destination, NumberType::Money);
+		return MakeNumberStringForCurrentLanguage(total, outReplacement, NumberType::Money);
 	}
 
 	static constexpr frozen::unordered_map <uint32_t, frozen::string, 9> capReliefNames =
@@ -722,12 +716,14 @@ namespace
 
 	bool GetCapReliefToken(const UnknownTokenContext* context, cIGZString& outReplacement, TokenSeparatorType type)
 	{
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot)
 		{
 			constexpr uint32_t kDemandSatisfiedPropertyID = 0x27812840;
 			constexpr uint32_t kDemandSatisfiedFloatPropertyID = 0x27812842;
 
-			const cISCPropertyHolder* pPropertyHolder = context->pOccupant->AsPropertyHolder();
+			const cISCPropertyHolder* pPropertyHolder = pSnapshot->GetPropertyHolder();
 
 			const cISCProperty* pDemandSatisfiedProperty = pPropertyHolder->GetProperty(kDemandSatisfiedPropertyID);
 
@@ -845,9 +841,11 @@ namespace
 	{
 		bool result = false;
 
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot)
 		{
-			const cISCPropertyHolder* pPropertyHolder = context->pOccupant->AsPropertyHolder();
+			const cISCPropertyHolder* pPropertyHolder = pSnapshot->GetPropertyHolder();
 
 			const cISCProperty* pEffectProperty = pPropertyHolder->GetProperty(static_cast<uint32_t>(type));
 
@@ -921,9 +919,11 @@ namespace
 	{
 		bool result = false;
 
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot)
 		{
-			const cISCPropertyHolder* pPropertyHolder = context->pOccupant->AsPropertyHolder();
+			const cISCPropertyHolder* pPropertyHolder = pSnapshot->GetPropertyHolder();
 
 			const cISCProperty* pPollutionProperty = pPropertyHolder->GetProperty(static_cast<uint32_t>(type));
 
@@ -993,46 +993,43 @@ namespace
 
 	bool GetBuildingWealthToken(UnknownTokenContext* context, cIGZString& outReplacement)
 	{
-		if (context && context->pOccupant)
+		cISC4Lot* pOccupantLot = GetOccupantLot(context);
+
+		if (pOccupantLot)
 		{
-			cISC4Lot* pOccupantLot = GetOccupantLot(context);
+			cISC4BuildingOccupant::WealthType wealth = cISC4BuildingOccupant::WealthType::None;
+			const uint32_t buildingType = pOccupantLot->GetBuildingType(false);
 
-			if (pOccupantLot)
+			if (buildingType == 0)
+			{
+				wealth = static_cast<cISC4BuildingOccupant::WealthType>(pOccupantLot->GetOccupantWealth());
+			}
+			else
 			{
-				cISC4BuildingOccupant::WealthType wealth = cISC4BuildingOccupant::WealthType::None;
-				const uint32_t buildingType = pOccupantLot->GetBuildingType(false);
+				cISC4BuildingOccupant* pBuildingOccupant = pOccupantLot->GetBuilding();
 
-				if (buildingType == 0)
-				{
-					wealth = static_cast<cISC4BuildingOccupant::WealthType>(pOccupantLot->GetOccupantWealth());
-				}
-				else
+				if (pBuildingOccupant)
 				{
-					cISC4BuildingOccupant* pBuildingOccupant = pOccupantLot->GetBuilding();
-
-					if (pBuildingOccupant)
-					{
-						const cISC4BuildingOccupant::BuildingProfile& profile = pBuildingOccupant->GetBuildingProfile();
+					const cISC4BuildingOccupant::BuildingProfile& profile = pBuildingOccupant->GetBuildingProfile();
 
-						wealth = profile.wealth;
-					}
+					wealth = profile.wealth;
 				}
+			}
 
-				switch (wealth)
-				{
-				case cISC4BuildingOccupant::WealthType::None:
-					outReplacement.FromChar("None");
-					return true;
-				case cISC4BuildingOccupant::WealthType::Low:
-					outReplacement.FromChar("Low Wealth");
-					return true;
-				case cISC4BuildingOccupant::WealthType::Medium:
-					outReplacement.FromChar("Medium Wealth");
-					return true;
-				case cISC4BuildingOccupant::WealthType::High:
-					outReplacement.FromChar("High Wealth");
-					return true;
-				}
+			switch (wealth)
+			{
+			case cISC4BuildingOccupant::WealthType::None:
+				outReplacement.FromChar("None");
+				return true;
+			case cISC4BuildingOccupant::WealthType::Low:
+				outReplacement.FromChar("Low Wealth");
+				return true;
+			case cISC4BuildingOccupant::WealthType::Medium:
+				outReplacement.FromChar("Medium Wealth");
+				return true;
+			case cISC4BuildingOccupant::WealthType::High:
+				outReplacement.FromChar("High Wealth");
+				return true;
 			}
 		}
 
@@ -1044,12 +1041,14 @@ namespace
 	{
 		int64_t cost = 0;
 
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot)
 		{
 			constexpr uint32_t kBulldozeCostPropertyID = 0x099afacd;
 
 			if (!SCPropertyUtil::GetPropertyValue(
-				context->pOccupant->AsPropertyHolder(),
+				pSnapshot->GetPropertyHolder(),
 				kBulldozeCostPropertyID,
 				cost))
 			{
@@ -1067,10 +1066,12 @@ namespace
 	{
 		uint8_t value = 0;
 
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot)
 		{
 			if (!SCPropertyUtil::GetPropertyValue(
-				context->pOccupant->AsPropertyHolder(),
+				pSnapshot->GetPropertyHolder(),
 				propertyID,
 				value))
 			{
@@ -1088,10 +1089,12 @@ namespace
 	{
 		uint32_t value = 0;
 
-		if (context && context->pOccupant)
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot)
 		{
 			if (!SCPropertyUtil::GetPropertyValue(
-				context->pOccupant->AsPropertyHolder(),
+				pSnapshot->GetPropertyHolder(),
 				propertyID,
 				value))
 			{
@@ -1106,7 +1109,7 @@ namespace
 
 	using DeveloperType = cISC4BuildingDevelopmentSimulator::DeveloperType;
 
-	static constexpr frozen::unordered_map<frozen::string, TokenDataCallback, 53> tokenDataCallbacks =
+	static constexpr frozen::unordered_map<frozen::string, TokenDataCallback, 56> tokenDataCallbacks =
 	{
 		{ "building_full_funding_capacity", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetBuildingFullFundingToken(ctx, dest, BuildingFundingType::Capacity); } },
 		{ "building_full_funding_coverage", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetBuildingFullFundingToken(ctx, dest, BuildingFundingType::Coverage); } },
@@ -1116,12 +1119,12 @@ namespace
 		{ "building_summary", GetBuildingSummaryToken },
 		{ "growth_stage", GetGrowthStageToken },
 		{ "mysim_name", GetMySimResidentName },
-		{ "jobs_low_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotJobCount(ctx, dest, JobType::LowWealth); }},
-		{ "jobs_medium_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotJobCount(ctx, dest, JobType::MediumWealth); }},
-		{ "jobs_high_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotJobCount(ctx, dest, JobType::HighWealth); }},
-		{ "travel_jobs_low_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotTravelJobCount(ctx, dest, JobType::LowWealth); }},
-		{ "travel_jobs_medium_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotTravelJobCount(ctx, dest, JobType::MediumWealth); }},
-		{ "travel_jobs_high_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotTravelJobCount(ctx, dest, JobType::HighWealth); }},
+		{ "jobs_low_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotJobCount(ctx, dest, JobType::Low); }},
+		{ "jobs_medium_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotJobCount(ctx, dest, JobType::Medium); }},
+		{ "jobs_high_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotJobCount(ctx, dest, JobType::High); }},
+		{ "travel_jobs_low_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotTravelJobCount(ctx, dest, JobType::Low); }},
+		{ "travel_jobs_medium_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotTravelJobCount(ctx, dest, JobType::Medium); }},
+		{ "travel_jobs_high_wealth", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetLotTravelJobCount(ctx, dest, JobType::High); }},
 		{ "r1_occupancy", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetOccupancyToken(ctx, dest, DeveloperType::ResidentialLowWealth); } },
 		{ "r1_capacity", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetCapacityToken(ctx, dest, DeveloperType::ResidentialLowWealth); } },
 		{ "r2_occupancy", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetOccupancyToken(ctx, dest, DeveloperType::ResidentialMediumWealth); } },
@@ -1155,6 +1158,9 @@ namespace
 		{ "mayor_rating_effect", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetBuildingEffectToken(ctx, dest, BuildingEffectType::MayorRating); } },
 		{ "pollution_at_center", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetBuildingPollutionToken(ctx, dest, BuildingPollutionType::AtCenter); } },
 		{ "pollution_radii", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetBuildingPollutionToken(ctx, dest, BuildingPollutionType::Radii); } },
+		{ "budget_purpose_type_cost_all", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetBudgetPurposeTypeCostAllToken(ctx, dest, TokenSeparatorType::Pipe); } },
+		{ "budget_purpose_type_cost_all_lines", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetBudgetPurposeTypeCostAllToken(ctx, dest, TokenSeparatorType::NewLine); } },
+		{ "budget_total", GetBudgetTotalToken },
 		{ "building_wealth", GetBuildingWealthToken },
 		{ "bulldoze_cost", GetBulldozeCostToken },
 		{ "flammability", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetUint8NumberToken(ctx, dest, 0x29244db5); } },
@@ -1163,147 +1169,1080 @@ namespace
 		{ "water_consumed", [](UnknownTokenContext* ctx, cIGZString& dest) { return GetUint32NumberToken(ctx, dest, 0xc8ed2d84); } },
 	};
 
-	typedef bool (*ParameterizedTokenDataCallback)(
-		std::string_view const& token,
-		std::string_view const& prefix,
-		UnknownTokenContext* context,
-		cIGZString& destination);
+	enum class TokenCacheType
+	{
+		// The token value is computed every time it is requested.
+		None = 0,
+		// The token value only depends on the building exemplar, it is cached by building type.
+		BuildingType,
+	};
 
-	static constexpr std::array<std::pair<std::string_view, ParameterizedTokenDataCallback>, 1> parameterizedTokenCallbacks =
+	static constexpr frozen::unordered_map<frozen::string, TokenCacheType, 16> tokenCacheTypes =
 	{
-		std::pair("budget_purpose_type_cost:"sv, GetBudgetPurposeTypeCost),
+		{ "building_is_w2w", TokenCacheType::BuildingType },
+		{ "building_styles", TokenCacheType::BuildingType },
+		{ "building_style_lines", TokenCacheType::BuildingType },
+		{ "bulldoze_cost", TokenCacheType::BuildingType },
+		{ "cap_relief", TokenCacheType::BuildingType },
+		{ "cap_relief_lines", TokenCacheType::BuildingType },
+		{ "crime_effect", TokenCacheType::BuildingType },
+		{ "flammability", TokenCacheType::BuildingType },
+		{ "landmark_effect", TokenCacheType::BuildingType },
+		{ "max_fire_stage", TokenCacheType::BuildingType },
+		{ "mayor_rating_effect", TokenCacheType::BuildingType },
+		{ "park_effect", TokenCacheType::BuildingType },
+		{ "pollution_at_center", TokenCacheType::BuildingType },
+		{ "pollution_radii", TokenCacheType::BuildingType },
+		{ "power_consumed", TokenCacheType::BuildingType },
+		{ "water_consumed", TokenCacheType::BuildingType },
 	};
 
-	bool GetParameterizedTokenCallback(std::string_view const& token, std::pair<std::string_view, ParameterizedTokenDataCallback>& entry)
+	TokenCacheType GetTokenCacheType(std::string_view const& token)
 	{
-		for (const auto& item : parameterizedTokenCallbacks)
-		{
-			if (token.starts_with(item.first))
-			{
-				entry = item;
-				return true;
-			}
-		}
+		const auto& entry = tokenCacheTypes.find(frozen::string(token));
 
-		return false;
+		return entry != tokenCacheTypes.end() ? entry->second : TokenCacheType::None;
 	}
 
-	bool UnknownTokenCallback(cIGZString const& token, cIGZString& outReplacement, void* pContext)
+	bool GetTokenValue(
+		std::string_view const& token,
+		TokenDataCallback callback,
+		TokenCacheType cacheType,
+		UnknownTokenContext* context,
+		cIGZString& destination)
 	{
-		bool result = false;
-
-		const std::string_view tokenAsStringView(token.Data(), token.Strlen());
-
-		const auto& entry = tokenDataCallbacks.find(frozen::string(tokenAsStringView));
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
 
-		if (entry != tokenDataCallbacks.end())
+		if (!pSnapshot || cacheType == TokenCacheType::None || !spLanguageManager)
 		{
-			UnknownTokenContext* context = static_cast<UnknownTokenContext*>(pContext);
-
-			// The string may have been set to an error message by some other token callback method.
-			outReplacement.Erase(0, outReplacement.Strlen());
-
-			if (!entry->second(context, outReplacement))
-			{
-				// Return an empty string if the handler method failed.
-				outReplacement.Erase(0, outReplacement.Strlen());
-			}
-
-			// Let the game know that the token was handled.
-			result = true;
+			return callback(context, destination);
 		}
-		else
-		{
-			std::pair<std::string_view, ParameterizedTokenDataCallback> entry;
 
-			if (GetParameterizedTokenCallback(tokenAsStringView, entry))
-			{
-				UnknownTokenContext* context = static_cast<UnknownTokenContext*>(pContext);
+		const uint32_t languageID = spLanguageManager->GetCurrentLanguage();
+		const uint32_t buildingType = pSnapshot->GetBuildingType();
 
-				// The string may have been set to an error message by some other token callback method.
-				outReplacement.Erase(0, outReplacement.Strlen());
+		if (buildingType == 0 || !context->pBuildingTypeTokenCache)
+		{
+			return callback(context, destination);
+		}
 
-				if (!entry.second(tokenAsStringView, entry.first, context, outReplacement))
-				{
-					// Return an empty string if the handler method failed.
-					outReplacement.Erase(0, outReplacement.Strlen());
-				}
+		if (context->pBuildingTypeTokenCache->TryGet(buildingType, languageID, token, destination))
+		{
+			return true;
+		}
 
-				// Let the game know that the token was handled.
-				result = true;
-			}
+		if (!callback(context, destination))
+		{
+			return false;
 		}
 
-		return result;
+		context->pBuildingTypeTokenCache->Add(buildingType, languageID, token, destination);
+		return true;
 	}
 
-	// The current token context is stored in a static variable to ensure that the
-	// memory remains valid between calls to BeforeDialogShown and AfterDialogShown.
-	static UnknownTokenContext sCurrentTokenContext;
+	typedef bool (*TokenParameterParser)(std::string_view const& text, TokenParameters& parameters);
 
-	void DebugLogTokenizerVariables()
+	typedef bool (*ParameterizedTokenDataCallback)(
+		TokenParameters const& parameters,
+		UnknownTokenContext* context,
+		cIGZString& destination);
+
+	bool ParsePropertyIndexParameters(std::string_view const& text, TokenParameters& parameters)
 	{
-		for (const auto& entry : tokenDataCallbacks)
-		{
-			cRZBaseString token("#", 1);
-			token.Append(entry.first.data(), entry.first.size());
-			token.Append("#", 1);
+		// The parameters use the format <property id>:<index>, e.g. 0x27812810:1.
 
-			PrintDetokenizedValueToDebugOutput(token);
+		const size_t separatorIndex = text.find(':');
+
+		if (separatorIndex == std::string_view::npos)
+		{
+			return false;
 		}
 
-		// Parameterized tokens
+		TokenParameters propertyIDParameters;
 
-		// 0xaa59670c is the Landmark Effect purpose id.
-		PrintDetokenizedValueToDebugOutput(cRZBaseString("#budget_purpose_type_cost:0xaa59670c#"));
-	}
-}
+		if (!ParseHexIDParameter(text.substr(0, separatorIndex), propertyIDParameters))
+		{
+			return false;
+		}
 
-BuildingQueryVariablesProvider::BuildingQueryVariablesProvider(const ISettings& settings)
-	: settings(settings),
-	  queryUILuaExtensions()
-{
-}
+		const std::string_view indexText = text.substr(separatorIndex + 1);
+		const char* const indexTextEnd = indexText.data() + indexText.size();
 
-bool BuildingQueryVariablesProvider::QueryInterface(uint32_t riid, void** ppvObj)
-{
-	if (riid == GZIID_cIBuildingQueryHookTarget)
-	{
-		*ppvObj = static_cast<cIBuildingQueryDialogHookTarget*>(this);
-		AddRef();
+		uint32_t index = 0;
+		const auto result = std::from_chars(indexText.data(), indexTextEnd, index);
 
+		if (indexText.empty() || result.ec != std::errc() || result.ptr != indexTextEnd)
+		{
+			return false;
+		}
+
+		parameters.values[0] = propertyIDParameters.values[0];
+		parameters.values[1] = index;
+		parameters.count = 2;
 		return true;
 	}
 
-	return DataProviderBase::QueryInterface(riid, ppvObj);
-}
+	static constexpr frozen::unordered_map<frozen::string, DeveloperType, 12> developerTypeNames =
+	{
+		{ "r1", DeveloperType::ResidentialLowWealth },
+		{ "r2", DeveloperType::ResidentialMediumWealth },
+		{ "r3", DeveloperType::ResidentialHighWealth },
+		{ "cs1", DeveloperType::CommercialServicesLowWealth },
+		{ "cs2", DeveloperType::CommercialServicesMediumWealth },
+		{ "cs3", DeveloperType::CommercialServicesHighWealth },
+		{ "co2", DeveloperType::CommercialOfficeMediumWealth },
+		{ "co3", DeveloperType::CommercialOfficeHighWealth },
+		{ "ir", DeveloperType::IndustrialAgriculture },
+		{ "id", DeveloperType::IndustrialProcessing },
+		{ "im", DeveloperType::IndustrialManufacturing },
+		{ "iht", DeveloperType::IndustrialHighTech },
+	};
 
-uint32_t BuildingQueryVariablesProvider::AddRef()
-{
-	return DataProviderBase::AddRef();
-}
+	bool ParsePropertyNameParameter(std::string_view const& text, TokenParameters& parameters)
+	{
+		// The name is resolved to a property id when the token is compiled.
 
-uint32_t BuildingQueryVariablesProvider::Release()
-{
-	return DataProviderBase::Release();
-}
+		uint32_t propertyID = 0;
 
-void BuildingQueryVariablesProvider::PostCityInit(cIGZMessage2Standard* pStandardMsg, cIGZCOM* pCOM)
-{
-	cISC4City* pCity = static_cast<cISC4City*>(pStandardMsg->GetVoid1());
+		if (PropertyNameDictionary::TryGetPropertyID(text, propertyID))
+		{
+			parameters.values[0] = propertyID;
+			parameters.count = 1;
+			return true;
+		}
 
-	cRZAutoRefCount<cIBuildingQueryHookServer> hookServer;
+		return false;
+	}
 
-	if (pCOM->GetClassObject(
-		GZCLSID_cIBuildingQueryHookServer,
-		GZIID_cIBuildingQueryHookServer,
-		hookServer.AsPPVoid()))
+	bool ParseDeveloperTypeParameter(std::string_view const& text, TokenParameters& parameters)
 	{
-		hookServer->AddNotification(this);
-	}
+		const auto& entry = developerTypeNames.find(frozen::string(text));
 
-	queryUILuaExtensions.PostCityInit(pCity->GetAdvisorSystem());
-}
+		if (entry != developerTypeNames.end())
+		{
+			parameters.values[0] = static_cast<uint32_t>(entry->second);
+			parameters.count = 1;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool GetDeveloperCapacityToken(
+		TokenParameters const& parameters,
+		UnknownTokenContext* context,
+		cIGZString& destination)
+	{
+		if (parameters.count != 1)
+		{
+			return false;
+		}
+
+		return GetCapacityToken(context, destination, static_cast<DeveloperType>(parameters.values[0]));
+	}
+
+	bool GetDeveloperOccupancyToken(
+		TokenParameters const& parameters,
+		UnknownTokenContext* context,
+		cIGZString& destination)
+	{
+		if (parameters.count != 1)
+		{
+			return false;
+		}
+
+		return GetOccupancyToken(context, destination, static_cast<DeveloperType>(parameters.values[0]));
+	}
+
+	bool AppendBoolValue(bool value, cIGZString& destination)
+	{
+		if (value)
+		{
+			destination.Append("Yes", 3);
+		}
+		else
+		{
+			destination.Append("No", 2);
+		}
+
+		return true;
+	}
+
+	template <typename T>
+	bool AppendNumberValue(T value, cIGZString& destination)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			char buffer[64]{};
+
+			const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+			if (result.ec != std::errc())
+			{
+				return false;
+			}
+
+			destination.Append(buffer, static_cast<uint32_t>(result.ptr - buffer));
+		}
+		else
+		{
+			cRZBaseString formatted;
+
+			if (!MakeNumberStringForCurrentLanguage(static_cast<int64_t>(value), formatted))
+			{
+				return false;
+			}
+
+			destination.Append(formatted);
+		}
+
+		return true;
+	}
+
+	uint32_t GetVariantValueCount(const cIGZVariant* pVariant)
+	{
+		switch (static_cast<cIGZVariant::Type>(pVariant->GetType()))
+		{
+		case cIGZVariant::Type::BoolArray:
+		case cIGZVariant::Type::Uint8Array:
+		case cIGZVariant::Type::Sint8Array:
+		case cIGZVariant::Type::Uint16Array:
+		case cIGZVariant::Type::Sint16Array:
+		case cIGZVariant::Type::Uint32Array:
+		case cIGZVariant::Type::Sint32Array:
+		case cIGZVariant::Type::Uint64Array:
+		case cIGZVariant::Type::Sint64Array:
+		case cIGZVariant::Type::Float32Array:
+		case cIGZVariant::Type::Float64Array:
+			return pVariant->GetCount();
+		default:
+			return 1;
+		}
+	}
+
+	bool AppendVariantValue(const cIGZVariant* pVariant, uint32_t index, cIGZString& destination)
+	{
+		switch (static_cast<cIGZVariant::Type>(pVariant->GetType()))
+		{
+		case cIGZVariant::Type::Bool:
+			return AppendBoolValue(pVariant->GetValBool(), destination);
+		case cIGZVariant::Type::BoolArray:
+			return AppendBoolValue(pVariant->RefBool()[index], destination);
+		case cIGZVariant::Type::Uint8:
+			return AppendNumberValue(pVariant->GetValUint8(), destination);
+		case cIGZVariant::Type::Uint8Array:
+			return AppendNumberValue(pVariant->RefUint8()[index], destination);
+		case cIGZVariant::Type::Sint8:
+			return AppendNumberValue(pVariant->GetValSint8(), destination);
+		case cIGZVariant::Type::Sint8Array:
+			return AppendNumberValue(pVariant->RefSint8()[index], destination);
+		case cIGZVariant::Type::Uint16:
+			return AppendNumberValue(pVariant->GetValUint16(), destination);
+		case cIGZVariant::Type::Uint16Array:
+			return AppendNumberValue(pVariant->RefUint16()[index], destination);
+		case cIGZVariant::Type::Sint16:
+			return AppendNumberValue(pVariant->GetValSint16(), destination);
+		case cIGZVariant::Type::Sint16Array:
+			return AppendNumberValue(pVariant->RefSint16()[index], destination);
+		case cIGZVariant::Type::Uint32:
+			return AppendNumberValue(pVariant->GetValUint32(), destination);
+		case cIGZVariant::Type::Uint32Array:
+			return AppendNumberValue(pVariant->RefUint32()[index], destination);
+		case cIGZVariant::Type::Sint32:
+			return AppendNumberValue(pVariant->GetValSint32(), destination);
+		case cIGZVariant::Type::Sint32Array:
+			return AppendNumberValue(pVariant->RefSint32()[index], destination);
+		case cIGZVariant::Type::Uint64:
+			return AppendNumberValue(pVariant->GetValUint64(), destination);
+		case cIGZVariant::Type::Uint64Array:
+			return AppendNumberValue(pVariant->RefUint64()[index], destination);
+		case cIGZVariant::Type::Sint64:
+			return AppendNumberValue(pVariant->GetValSint64(), destination);
+		case cIGZVariant::Type::Sint64Array:
+			return AppendNumberValue(pVariant->RefSint64()[index], destination);
+		case cIGZVariant::Type::Float32:
+			return AppendNumberValue(pVariant->GetValFloat32(), destination);
+		case cIGZVariant::Type::Float32Array:
+			return AppendNumberValue(pVariant->RefFloat32()[index], destination);
+		case cIGZVariant::Type::Float64:
+			return AppendNumberValue(pVariant->GetValFloat64(), destination);
+		case cIGZVariant::Type::Float64Array:
+			return AppendNumberValue(pVariant->RefFloat64()[index], destination);
+		default:
+			cRZBaseString asString;
+			pVariant->GetValString(asString);
+
+			destination.Append(asString);
+			return true;
+		}
+	}
+
+	const cIGZVariant* GetPropertyVariant(const UnknownTokenContext* context, uint32_t propertyID)
+	{
+		const cIGZVariant* pVariant = nullptr;
+
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+		if (pSnapshot && pSnapshot->GetPropertyHolder())
+		{
+			const cISCProperty* pProperty = pSnapshot->GetPropertyHolder()->GetProperty(propertyID);
+
+			if (pProperty)
+			{
+				pVariant = pProperty->GetPropertyValue();
+			}
+		}
+
+		return pVariant;
+	}
+
+	bool GetPropertyToken(
+		TokenParameters const& parameters,
+		UnknownTokenContext* context,
+		cIGZString& destination)
+	{
+		if (parameters.count != 1)
+		{
+			return false;
+		}
+
+		const cIGZVariant* pVariant = GetPropertyVariant(context, parameters.values[0]);
+
+		if (!pVariant)
+		{
+			return false;
+		}
+
+		const uint32_t count = GetVariantValueCount(pVariant);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (i > 0)
+			{
+				destination.Append(", ", 2);
+			}
+
+			if (!AppendVariantValue(pVariant, i, destination))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool GetPropertyIndexToken(
+		TokenParameters const& parameters,
+		UnknownTokenContext* context,
+		cIGZString& destination)
+	{
+		if (parameters.count != 2)
+		{
+			return false;
+		}
+
+		const cIGZVariant* pVariant = GetPropertyVariant(context, parameters.values[0]);
+		const uint32_t index = parameters.values[1];
+
+		if (!pVariant || index >= GetVariantValueCount(pVariant))
+		{
+			return false;
+		}
+
+		return AppendVariantValue(pVariant, index, destination);
+	}
+
+	struct ParameterizedTokenEntry
+	{
+		TokenParameterParser parser;
+		ParameterizedTokenDataCallback callback;
+	};
+
+	// The parameterized tokens use the format <prefix>:<parameters>, they are looked
+	// up using the text before the first colon.
+	static constexpr frozen::unordered_map<frozen::string, ParameterizedTokenEntry, 6> parameterizedTokenCallbacks =
+	{
+		{ "budget_purpose_type_cost", { ParseHexIDParameter, GetBudgetPurposeTypeCost } },
+		{ "capacity", { ParseDeveloperTypeParameter, GetDeveloperCapacityToken } },
+		{ "occupancy", { ParseDeveloperTypeParameter, GetDeveloperOccupancyToken } },
+		{ "property", { ParseHexIDParameter, GetPropertyToken } },
+		{ "property_index", { ParsePropertyIndexParameters, GetPropertyIndexToken } },
+		{ "property_name", { ParsePropertyNameParameter, GetPropertyToken } },
+	};
+
+	enum class ExpressionSourceType : uint32_t
+	{
+		Occupancy = 0,
+		Capacity,
+		Jobs,
+		TravelJobs,
+		BudgetTotal,
+		BulldozeCost,
+		PropertyUint8,
+		PropertyUint32
+	};
+
+	// The named values that can be used in the expression tokens, in addition to
+	// the <developer type>_occupancy and <developer type>_capacity values.
+	static constexpr frozen::unordered_map<frozen::string, QueryExpression::Source, 12> expressionSourceNames =
+	{
+		{ "jobs_low_wealth", { static_cast<uint32_t>(ExpressionSourceType::Jobs), static_cast<uint32_t>(JobType::Low) } },
+		{ "jobs_medium_wealth", { static_cast<uint32_t>(ExpressionSourceType::Jobs), static_cast<uint32_t>(JobType::Medium) } },
+		{ "jobs_high_wealth", { static_cast<uint32_t>(ExpressionSourceType::Jobs), static_cast<uint32_t>(JobType::High) } },
+		{ "travel_jobs_low_wealth", { static_cast<uint32_t>(ExpressionSourceType::TravelJobs), static_cast<uint32_t>(JobType::Low) } },
+		{ "travel_jobs_medium_wealth", { static_cast<uint32_t>(ExpressionSourceType::TravelJobs), static_cast<uint32_t>(JobType::Medium) } },
+		{ "travel_jobs_high_wealth", { static_cast<uint32_t>(ExpressionSourceType::TravelJobs), static_cast<uint32_t>(JobType::High) } },
+		{ "budget_total", { static_cast<uint32_t>(ExpressionSourceType::BudgetTotal), 0 } },
+		{ "bulldoze_cost", { static_cast<uint32_t>(ExpressionSourceType::BulldozeCost), 0x099afacd } },
+		{ "flammability", { static_cast<uint32_t>(ExpressionSourceType::PropertyUint8), 0x29244db5 } },
+		{ "max_fire_stage", { static_cast<uint32_t>(ExpressionSourceType::PropertyUint8), 0x49beda31 } },
+		{ "power_consumed", { static_cast<uint32_t>(ExpressionSourceType::PropertyUint32), 0x27812854 } },
+		{ "water_consumed", { static_cast<uint32_t>(ExpressionSourceType::PropertyUint32), 0xc8ed2d84 } },
+	};
+
+	bool ResolveExpressionSource(std::string_view const& name, QueryExpression::Source& source)
+	{
+		const auto& entry = expressionSourceNames.find(frozen::string(name));
+
+		if (entry != expressionSourceNames.end())
+		{
+			source = entry->second;
+			return true;
+		}
+
+		constexpr std::string_view OccupancySuffix = "_occupancy"sv;
+		constexpr std::string_view CapacitySuffix = "_capacity"sv;
+
+		std::string_view developerTypeName;
+		ExpressionSourceType type;
+
+		if (name.ends_with(OccupancySuffix))
+		{
+			developerTypeName = name.substr(0, name.size() - OccupancySuffix.size());
+			type = ExpressionSourceType::Occupancy;
+		}
+		else if (name.ends_with(CapacitySuffix))
+		{
+			developerTypeName = name.substr(0, name.size() - CapacitySuffix.size());
+			type = ExpressionSourceType::Capacity;
+		}
+		else
+		{
+			return false;
+		}
+
+		const auto& developerTypeEntry = developerTypeNames.find(frozen::string(developerTypeName));
+
+		if (developerTypeEntry != developerTypeNames.end())
+		{
+			source.type = static_cast<uint32_t>(type);
+			source.argument = static_cast<uint32_t>(developerTypeEntry->second);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool ReadExpressionSource(QueryExpression::Source const& source, const void* pContext, double& value)
+	{
+		const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(static_cast<const UnknownTokenContext*>(pContext));
+
+		if (!pSnapshot)
+		{
+			return false;
+		}
+
+		// The values match the values of the query variables with the same name,
+		// missing properties are treated as zero.
+
+		switch (static_cast<ExpressionSourceType>(source.type))
+		{
+		case ExpressionSourceType::Occupancy:
+			value = pSnapshot->GetPopulation(static_cast<DeveloperType>(source.argument));
+			break;
+		case ExpressionSourceType::Capacity:
+			value = pSnapshot->GetCapacity(static_cast<DeveloperType>(source.argument));
+			break;
+		case ExpressionSourceType::Jobs:
+			value = static_cast<double>(lroundf(pSnapshot->GetJobs(static_cast<JobType>(source.argument))));
+			break;
+		case ExpressionSourceType::TravelJobs:
+			value = pSnapshot->GetTravelJobs(static_cast<JobType>(source.argument));
+			break;
+		case ExpressionSourceType::BudgetTotal:
+			value = static_cast<double>(pSnapshot->GetBudgetTotal());
+			break;
+		case ExpressionSourceType::BulldozeCost:
+		{
+			int64_t cost = 0;
+			SCPropertyUtil::GetPropertyValue(pSnapshot->GetPropertyHolder(), source.argument, cost);
+			value = static_cast<double>(cost);
+			break;
+		}
+		case ExpressionSourceType::PropertyUint8:
+		{
+			uint8_t propertyValue = 0;
+			SCPropertyUtil::GetPropertyValue(pSnapshot->GetPropertyHolder(), source.argument, propertyValue);
+			value = propertyValue;
+			break;
+		}
+		case ExpressionSourceType::PropertyUint32:
+		{
+			uint32_t propertyValue = 0;
+			SCPropertyUtil::GetPropertyValue(pSnapshot->GetPropertyHolder(), source.argument, propertyValue);
+			value = propertyValue;
+			break;
+		}
+		default:
+			return false;
+		}
+
+		return true;
+	}
+
+	enum class ExpressionTokenType
+	{
+		// #if:<condition>:<true text>:<false text>#
+		Conditional = 0,
+		// #sum:<expression>,<expression>,...#
+		Sum,
+		// #pct:<expression>#
+		Percent
+	};
+
+	static constexpr frozen::unordered_map<frozen::string, ExpressionTokenType, 3> expressionTokenTypes =
+	{
+		{ "if", ExpressionTokenType::Conditional },
+		{ "sum", ExpressionTokenType::Sum },
+		{ "pct", ExpressionTokenType::Percent },
+	};
+
+	// A piece of the conditional token output, the text is followed by the value
+	// of the query variable that was written as {name}, if any.
+	struct ExpressionTemplatePart
+	{
+		std::string text;
+		std::string_view tokenName;
+		TokenDataCallback callback;
+		TokenCacheType cacheType;
+	};
+
+	struct CompiledExpressionToken
+	{
+		ExpressionTokenType type;
+		QueryExpression expression;
+		std::vector<ExpressionTemplatePart> trueParts;
+		std::vector<ExpressionTemplatePart> falseParts;
+	};
+
+	std::vector<ExpressionTemplatePart> CompileExpressionTemplate(std::string_view const& text)
+	{
+		std::vector<ExpressionTemplatePart> parts;
+		ExpressionTemplatePart current{ std::string(), std::string_view(), nullptr, TokenCacheType::None };
+
+		size_t position = 0;
+
+		while (position < text.size())
+		{
+			const size_t openIndex = text.find('{', position);
+
+			if (openIndex == std::string_view::npos)
+			{
+				break;
+			}
+
+			const size_t closeIndex = text.find('}', openIndex + 1);
+
+			if (closeIndex == std::string_view::npos)
+			{
+				break;
+			}
+
+			const std::string_view name = text.substr(openIndex + 1, closeIndex - openIndex - 1);
+			const auto& entry = tokenDataCallbacks.find(frozen::string(name));
+
+			if (entry != tokenDataCallbacks.end())
+			{
+				current.text.append(text.substr(position, openIndex - position));
+				current.tokenName = std::string_view(entry->first.data(), entry->first.size());
+				current.callback = entry->second;
+				current.cacheType = GetTokenCacheType(current.tokenName);
+				parts.push_back(std::move(current));
+
+				current = ExpressionTemplatePart{ std::string(), std::string_view(), nullptr, TokenCacheType::None };
+			}
+			else
+			{
+				// Unknown names are kept as literal text.
+				current.text.append(text.substr(position, closeIndex + 1 - position));
+			}
+
+			position = closeIndex + 1;
+		}
+
+		current.text.append(text.substr(position));
+
+		if (!current.text.empty())
+		{
+			parts.push_back(std::move(current));
+		}
+
+		return parts;
+	}
+
+	std::unique_ptr<CompiledExpressionToken> CompileExpressionToken(
+		ExpressionTokenType type,
+		std::string_view const& text)
+	{
+		auto compiled = std::make_unique<CompiledExpressionToken>();
+		compiled->type = type;
+
+		bool result = false;
+
+		switch (type)
+		{
+		case ExpressionTokenType::Conditional:
+		{
+			const size_t conditionEnd = text.find(':');
+
+			if (conditionEnd != std::string_view::npos)
+			{
+				result = compiled->expression.Compile(text.substr(0, conditionEnd), ResolveExpressionSource);
+
+				if (result)
+				{
+					// The false text is optional, it can contain colons.
+					const std::string_view branches = text.substr(conditionEnd + 1);
+					const size_t trueEnd = branches.find(':');
+
+					compiled->trueParts = CompileExpressionTemplate(branches.substr(0, trueEnd));
+
+					if (trueEnd != std::string_view::npos)
+					{
+						compiled->falseParts = CompileExpressionTemplate(branches.substr(trueEnd + 1));
+					}
+				}
+			}
+			break;
+		}
+		case ExpressionTokenType::Sum:
+			result = compiled->expression.CompileSum(text, ResolveExpressionSource);
+			break;
+		case ExpressionTokenType::Percent:
+			result = compiled->expression.Compile(text, ResolveExpressionSource);
+			break;
+		}
+
+		if (!result)
+		{
+			compiled.reset();
+		}
+
+		return compiled;
+	}
+
+	bool GetExpressionTokenValue(
+		CompiledExpressionToken const& compiled,
+		UnknownTokenContext* context,
+		cIGZString& destination)
+	{
+		double value = 0.0;
+
+		if (!compiled.expression.Evaluate(ReadExpressionSource, context, value))
+		{
+			return false;
+		}
+
+		bool result = false;
+
+		switch (compiled.type)
+		{
+		case ExpressionTokenType::Conditional:
+		{
+			const std::vector<ExpressionTemplatePart>& parts = value != 0.0 ? compiled.trueParts : compiled.falseParts;
+
+			result = true;
+
+			for (const ExpressionTemplatePart& part : parts)
+			{
+				destination.Append(part.text.data(), part.text.size());
+
+				if (part.callback)
+				{
+					cRZBaseString tokenValue;
+
+					if (!GetTokenValue(part.tokenName, part.callback, part.cacheType, context, tokenValue))
+					{
+						result = false;
+						break;
+					}
+
+					destination.Append(tokenValue.Data(), tokenValue.Strlen());
+				}
+			}
+			break;
+		}
+		case ExpressionTokenType::Sum:
+			result = MakeNumberStringForCurrentLanguage(llround(value), destination);
+			break;
+		case ExpressionTokenType::Percent:
+			result = MakeNumberStringForCurrentLanguage(llround(value * 100.0), destination);
+
+			if (result)
+			{
+				destination.Append("%", 1);
+			}
+			break;
+		}
+
+		return result;
+	}
+
+	// A token that has been resolved to its handler, along with any parameters that
+	// were parsed from the token text.
+	struct CompiledToken
+	{
+		std::string_view name;
+		TokenDataCallback callback;
+		TokenCacheType cacheType;
+		ParameterizedTokenDataCallback parameterizedCallback;
+		TokenParameters parameters;
+		std::unique_ptr<CompiledExpressionToken> expression;
+
+		CompiledToken()
+			: name(),
+			  callback(nullptr),
+			  cacheType(TokenCacheType::None),
+			  parameterizedCallback(nullptr),
+			  parameters(),
+			  expression()
+		{
+		}
+
+		bool IsUnknown() const
+		{
+			return !callback && !parameterizedCallback && !expression;
+		}
+	};
+
+	CompiledToken CompileToken(std::string_view const& token)
+	{
+		CompiledToken compiled;
+
+		const auto& entry = tokenDataCallbacks.find(frozen::string(token));
+
+		if (entry != tokenDataCallbacks.end())
+		{
+			// The token name is stored in the tokenDataCallbacks map, so it remains valid
+			// for as long as the building type cache.
+			compiled.name = std::string_view(entry->first.data(), entry->first.size());
+			compiled.callback = entry->second;
+			compiled.cacheType = GetTokenCacheType(compiled.name);
+		}
+		else
+		{
+			const size_t separatorIndex = token.find(':');
+
+			if (separatorIndex != std::string_view::npos)
+			{
+				const frozen::string prefix(token.substr(0, separatorIndex));
+				const auto& parameterizedEntry = parameterizedTokenCallbacks.find(prefix);
+
+				if (parameterizedEntry != parameterizedTokenCallbacks.end())
+				{
+					compiled.parameterizedCallback = parameterizedEntry->second.callback;
+
+					if (!parameterizedEntry->second.parser(token.substr(separatorIndex + 1), compiled.parameters))
+					{
+						// The handler is still called so that it can write its default value.
+						compiled.parameters = TokenParameters();
+					}
+				}
+				else
+				{
+					const auto& expressionEntry = expressionTokenTypes.find(prefix);
+
+					if (expressionEntry != expressionTokenTypes.end())
+					{
+						// Expressions that fail to compile are left unhandled so the
+						// game shows the token text, which makes the mistake visible.
+						compiled.expression = CompileExpressionToken(
+							expressionEntry->second,
+							token.substr(separatorIndex + 1));
+					}
+				}
+			}
+		}
+
+		return compiled;
+	}
+
+	struct TransparentStringHash
+	{
+		using is_transparent = void;
+
+		size_t operator()(std::string_view const& value) const noexcept
+		{
+			return std::hash<std::string_view>{}(value);
+		}
+	};
+
+	// The game calls UnknownTokenCallback for every token it doesn't recognize each time
+	// a query dialog string is detokenized, so the result of resolving each token string
+	// is cached. Tokens that have no handler are also cached to skip the lookup the next
+	// time they are seen.
+	// The token set used by the LTEXT files is small, the limit only exists to stop
+	// the cache growing without bounds if some other plugin generates its token names.
+	constexpr size_t CompiledTokenCacheLimit = 1024;
+
+	static std::unordered_map<std::string, CompiledToken, TransparentStringHash, std::equal_to<>> sCompiledTokens;
+
+	const CompiledToken& GetCompiledToken(std::string_view const& token)
+	{
+		auto it = sCompiledTokens.find(token);
+
+		if (it == sCompiledTokens.end())
+		{
+			if (sCompiledTokens.size() >= CompiledTokenCacheLimit)
+			{
+				sCompiledTokens.clear();
+			}
+
+			it = sCompiledTokens.emplace(std::string(token), CompileToken(token)).first;
+		}
+
+		return it->second;
+	}
+
+	// The query dialog can be opened again while it is being shown, e.g. by the Lua
+	// window_query function, so each dialog pushes its own token context.
+	// The detokenizer callback always uses the context of the innermost dialog.
+	typedef std::vector<UnknownTokenContext> TokenContextStack;
+
+	bool UnknownTokenCallback(cIGZString const& token, cIGZString& outReplacement, void* pContext)
+	{
+		TokenContextStack* pContextStack = static_cast<TokenContextStack*>(pContext);
+
+		// The callback stays registered for the lifetime of the application, the tokens
+		// are only handled while a building query dialog is being shown.
+		if (!pContextStack || pContextStack->empty())
+		{
+			return false;
+		}
+
+		UnknownTokenContext* context = &pContextStack->back();
+
+		const std::string_view tokenAsStringView(token.Data(), token.Strlen());
+
+		const CompiledToken& compiled = GetCompiledToken(tokenAsStringView);
+
+		if (compiled.IsUnknown())
+		{
+			// Try the variables that other DLLs registered through cIBuildingQueryVariableRegistry.
+			if (spBuildingQueryVariableRegistry && spBuildingQueryVariableRegistry->HasRegisteredVariables())
+			{
+				const BuildingOccupantSnapshot* pSnapshot = GetOccupantSnapshot(context);
+
+				if (pSnapshot)
+				{
+					return spBuildingQueryVariableRegistry->GetVariableValue(
+						pSnapshot->GetOccupant(),
+						tokenAsStringView,
+						outReplacement);
+				}
+			}
+
+			return false;
+		}
+
+		// The string may have been set to an error message by some other token callback method.
+		outReplacement.Erase(0, outReplacement.Strlen());
+
+		bool handlerResult = false;
+
+		if (compiled.callback)
+		{
+			handlerResult = GetTokenValue(compiled.name, compiled.callback, compiled.cacheType, context, outReplacement);
+		}
+		else if (compiled.expression)
+		{
+			handlerResult = GetExpressionTokenValue(*compiled.expression, context, outReplacement);
+		}
+		else
+		{
+			handlerResult = compiled.parameterizedCallback(compiled.parameters, context, outReplacement);
+		}
+
+		if (!handlerResult)
+		{
+			// Return an empty string if the handler method failed.
+			outReplacement.Erase(0, outReplacement.Strlen());
+		}
+
+		// Let the game know that the token was handled.
+		return true;
+	}
+
+	// The token context stack is stored in a static variable to ensure that the
+	// memory remains valid for as long as the detokenizer callback is registered.
+	static TokenContextStack sTokenContextStack;
+
+	void DebugLogTokenizerVariables()
+	{
+		for (const auto& entry : tokenDataCallbacks)
+		{
+			cRZBaseString token("#", 1);
+			token.Append(entry.first.data(), entry.first.size());
+			token.Append("#", 1);
+
+			PrintDetokenizedValueToDebugOutput(token);
+		}
+
+		// Parameterized tokens
+
+		// 0xaa59670c is the Landmark Effect purpose id.
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#budget_purpose_type_cost:0xaa59670c#"));
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#capacity:r1#"));
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#occupancy:r1#"));
+		// 0x27812810 is the Occupant Size property id.
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#property:0x27812810#"));
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#property_index:0x27812810:1#"));
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#property_name:Bulldoze Cost#"));
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#if:r1_occupancy==0:Vacant:{r1_occupancy} residents#"));
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#sum:jobs_low_wealth,jobs_medium_wealth,jobs_high_wealth#"));
+		PrintDetokenizedValueToDebugOutput(cRZBaseString("#pct:r1_occupancy/r1_capacity#"));
+	}
+
+#ifdef _DEBUG
+	// The body of a building query dialog LTEXT that uses the DLL's variables.
+	static constexpr std::string_view BenchmarkQueryDialogText =
+		"#building_summary# (#building_wealth#)\n"
+		"Residents: #occupancy:r1# / #capacity:r1# (#pct:r1_occupancy/r1_capacity#)\n"
+		"#if:r1_occupancy==0:Vacant:{r1_occupancy} residents#\n"
+		"Jobs: #sum:jobs_low_wealth,jobs_medium_wealth,jobs_high_wealth#\n"
+		"Styles: #building_styles#\n"
+		"Growth stage: #growth_stage#, flammability: #flammability#\n"
+		"Bulldoze cost: #bulldoze_cost#";
+
+	// Compares registering and removing the detokenizer callback for each query dialog
+	// with the persistent callback and its token context stack. Each iteration detokenizes
+	// a query dialog string for the occupant of the dialog that is being shown.
+	void DebugBenchmarkDetokenizerRegistration()
+	{
+		if (!spStringDetokenizer || sTokenContextStack.empty())
+		{
+			return;
+		}
+
+		constexpr int32_t Iterations = 1000;
+
+		const cRZBaseString text(BenchmarkQueryDialogText.data(), static_cast<uint32_t>(BenchmarkQueryDialogText.size()));
+		cRZBaseString result;
+
+		// The persistent callback ignores the tokens while its context stack is empty, the
+		// contexts are moved to the stack of the callback that is registered for each dialog.
+		TokenContextStack dialogContextStack;
+		dialogContextStack.swap(sTokenContextStack);
+
+		const auto churnStart = std::chrono::steady_clock::now();
+
+		for (int32_t i = 0; i < Iterations; i++)
+		{
+			spStringDetokenizer->AddUnknownTokenReplacementMethod(&UnknownTokenCallback, &dialogContextStack, true);
+			spStringDetokenizer->Detokenize(text, result);
+			spStringDetokenizer->AddUnknownTokenReplacementMethod(&UnknownTokenCallback, &dialogContextStack, false);
+		}
+
+		const auto churnEnd = std::chrono::steady_clock::now();
+
+		sTokenContextStack.swap(dialogContextStack);
+
+		const UnknownTokenContext context = sTokenContextStack.back();
+
+		for (int32_t i = 0; i < Iterations; i++)
+		{
+			sTokenContextStack.push_back(context);
+			spStringDetokenizer->Detokenize(text, result);
+			sTokenContextStack.pop_back();
+		}
+
+		const auto persistentEnd = std::chrono::steady_clock::now();
+
+		DebugUtil::PrintLineToDebugOutputFormatted(
+			"Detokenizer registration: per-dialog callback = %lld us, persistent callback = %lld us (%d query dialog strings)",
+			static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(churnEnd - churnStart).count()),
+			static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(persistentEnd - churnEnd).count()),
+			Iterations);
+	}
+#endif // _DEBUG
+}
+
+BuildingQueryVariablesProvider::BuildingQueryVariablesProvider(const ISettings& settings)
+	: settings(settings),
+	  queryUILuaExtensions(settings),
+	  occupantSnapshots(),
+	  occupantSnapshotCache(OccupantSnapshotCacheCapacity),
+	  buildingTypeTokenCache(BuildingTypeTokenCacheCapacity),
+	  buildingStyleCache()
+{
+}
+
+bool BuildingQueryVariablesProvider::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIBuildingQueryHookTarget)
+	{
+		*ppvObj = static_cast<cIBuildingQueryDialogHookTarget*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return DataProviderBase::QueryInterface(riid, ppvObj);
+}
+
+uint32_t BuildingQueryVariablesProvider::AddRef()
+{
+	return DataProviderBase::AddRef();
+}
+
+uint32_t BuildingQueryVariablesProvider::Release()
+{
+	return DataProviderBase::Release();
+}
+
+void BuildingQueryVariablesProvider::PostAppInit(cIGZCOM* pCOM)
+{
+	if (spStringDetokenizer)
+	{
+		spStringDetokenizer->AddUnknownTokenReplacementMethod(&UnknownTokenCallback, &sTokenContextStack, true);
+	}
+}
+
+void BuildingQueryVariablesProvider::PreAppShutdown(cIGZCOM* pCOM)
+{
+	if (spStringDetokenizer)
+	{
+		spStringDetokenizer->AddUnknownTokenReplacementMethod(&UnknownTokenCallback, &sTokenContextStack, false);
+	}
+}
+
+void BuildingQueryVariablesProvider::PostCityInit(cIGZMessage2Standard* pStandardMsg, cIGZCOM* pCOM)
+{
+	cISC4City* pCity = static_cast<cISC4City*>(pStandardMsg->GetVoid1());
+
+	cRZAutoRefCount<cIBuildingQueryHookServer> hookServer;
+
+	if (pCOM->GetClassObject(
+		GZCLSID_cIBuildingQueryHookServer,
+		GZIID_cIBuildingQueryHookServer,
+		hookServer.AsPPVoid()))
+	{
+		hookServer->AddNotification(this);
+	}
+
+	queryUILuaExtensions.PostCityInit(pCity->GetAdvisorSystem());
+	buildingStyleCache.PostCityInit(pCOM);
+}
 
 void BuildingQueryVariablesProvider::PreCityShutdown(cIGZMessage2Standard* pStandardMsg, cIGZCOM* pCOM)
 {
@@ -1318,6 +2257,9 @@ void BuildingQueryVariablesProvider::PreCityShutdown(cIGZMessage2Standard* pStan
 	}
 
 	queryUILuaExtensions.PreCityShutdown();
+	occupantSnapshotCache.Clear();
+	buildingTypeTokenCache.Clear();
+	buildingStyleCache.PreCityShutdown();
 }
 
 void BuildingQueryVariablesProvider::BeforeDialogShown(cISC4Occupant* pOccupant)
@@ -1327,26 +2269,41 @@ void BuildingQueryVariablesProvider::BeforeDialogShown(cISC4Occupant* pOccupant)
 		BuildingPluginInfo::WriteToLog(pOccupant);
 	}
 
-	if (spStringDetokenizer)
-	{
-		sCurrentTokenContext.pOccupant = pOccupant;
+	const uint32_t languageID = spLanguageManager ? spLanguageManager->GetCurrentLanguage() : 0;
+
+	// The tokens, the expressions and the Lua extensions all read the cached snapshot,
+	// it is rebuilt when the language changes or on the next simulation month.
+	const BuildingOccupantSnapshot* pSnapshot = occupantSnapshots.emplace_back(
+		occupantSnapshotCache.Get(pOccupant, languageID, SimulationEpoch::Get())).get();
 
-		spStringDetokenizer->AddUnknownTokenReplacementMethod(&UnknownTokenCallback, &sCurrentTokenContext, true);
+	UnknownTokenContext& context = sTokenContextStack.emplace_back();
+	context.pSnapshot = pSnapshot;
+	context.pBuildingTypeTokenCache = &buildingTypeTokenCache;
+	context.pBuildingStyleCache = &buildingStyleCache;
 
 #ifdef _DEBUG
-		DebugLogTokenizerVariables();
-#endif // _DEBUG
+	DebugLogTokenizerVariables();
+
+	if (settings.BenchmarkDetokenizerRegistration())
+	{
+		DebugBenchmarkDetokenizerRegistration();
 	}
+#endif // _DEBUG
 
-	queryUILuaExtensions.BeforeDialogShown(pOccupant);
+	queryUILuaExtensions.BeforeDialogShown(pSnapshot);
 }
 
 void BuildingQueryVariablesProvider::AfterDialogShown(cISC4Occupant* pOccupant)
 {
-	if (spStringDetokenizer)
+	if (!sTokenContextStack.empty())
+	{
+		sTokenContextStack.pop_back();
+	}
+
+	if (!occupantSnapshots.empty())
 	{
-		spStringDetokenizer->AddUnknownTokenReplacementMethod(&UnknownTokenCallback, &sCurrentTokenContext, false);
+		occupantSnapshots.pop_back();
 	}
 
-	queryUILuaExtensions.AfterDialogShown(pOccupant);
+	queryUILuaExtensions.AfterDialogShown();
 }
@@ -20,10 +20,16 @@
  */
 
 #pragma once
+#include "BuildingOccupantSnapshot.h"
+#include "BuildingStyleCache.h"
+#include "BuildingTypeTokenCache.h"
 #include "DataProviderBase.h"
 #include "cIBuildingQueryDialogHookTarget.h"
 #include "ISettings.h"
+#include "OccupantSnapshotCache.h"
 #include "QueryUILuaExtensions.h"
+#include <memory>
+#include <vector>
 
 class BuildingQueryVariablesProvider final
 	: public DataProviderBase,
@@ -36,6 +42,9 @@ public:
 	uint32_t AddRef() override;
 	uint32_t Release() override;
 
+	void PostAppInit(cIGZCOM* pCOM) override;
+	void PreAppShutdown(cIGZCOM* pCOM) override;
+
 	void PostCityInit(cIGZMessage2Standard* pStandardMsg, cIGZCOM* pCOM) override;
 	void PreCityShutdown(cIGZMessage2Standard* pStandardMsg, cIGZCOM* pCOM) override;
 
@@ -43,6 +52,13 @@ private:
 	void BeforeDialogShown(cISC4Occupant* pOccupant) override;
 	void AfterDialogShown(cISC4Occupant* pOccupant) override;
 
+	static constexpr size_t OccupantSnapshotCacheCapacity = 64;
+	static constexpr size_t BuildingTypeTokenCacheCapacity = 256;
+
 	const ISettings& settings;
 	QueryUILuaExtensions queryUILuaExtensions;
+	std::vector<std::shared_ptr<const BuildingOccupantSnapshot>> occupantSnapshots;
+	OccupantSnapshotCache occupantSnapshotCache;
+	BuildingTypeTokenCache buildingTypeTokenCache;
+	BuildingStyleCache buildingStyleCache;
 };
\ No newline at end of file
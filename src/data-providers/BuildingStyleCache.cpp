@@ -0,0 +1,129 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BuildingStyleCache.h"
+#include "cIGZCOM.h"
+#include "cIGZString.h"
+#include "cISC4Occupant.h"
+#include "cRZBaseString.h"
+#include "Logger.h"
+#include <array>
+
+namespace
+{
+	static constexpr std::array<std::pair<uint32_t, std::string_view>, 4> MaxisBuildingStyles =
+	{
+		std::pair(0x2000, "Chicago 1890"),
+		std::pair(0x2001, "New York 1940"),
+		std::pair(0x2002, "Houston 1990"),
+		std::pair(0x2003, "Euro-Contemporary"),
+	};
+}
+
+BuildingStyleCache::BuildingStyleCache()
+	: buildingStyleInfo(),
+	  loggedMissingBuildingStyleInfo(false)
+{
+}
+
+void BuildingStyleCache::PostCityInit(cIGZCOM* pCOM)
+{
+	if (!pCOM->GetClassObject(
+		GZCLSID_cIBuildingStyleInfo,
+		GZIID_cIBuildingStyleInfo2,
+		buildingStyleInfo.AsPPVoid()))
+	{
+		buildingStyleInfo.Reset();
+	}
+}
+
+void BuildingStyleCache::PreCityShutdown()
+{
+	buildingStyleInfo.Reset();
+}
+
+bool BuildingStyleCache::AppendStyleNames(
+	cISC4Occupant* pOccupant,
+	std::string_view separator,
+	cIGZString& destination)
+{
+	bool result = false;
+
+	if (pOccupant)
+	{
+		if (buildingStyleInfo)
+		{
+			// If the More Building Styles DLL is installed we check the building's OccupantGroups
+			// for any styles that are present in the Building Style Control.
+			result = buildingStyleInfo->GetBuildingStyleNamesEx(
+				pOccupant,
+				destination,
+				cRZBaseString(separator.data(), separator.size()));
+		}
+		else
+		{
+			// If the More Building Styles DLL is not installed we fall back to checking for
+			// the 4 built-in Maxis styles.
+
+			for (const auto& item : MaxisBuildingStyles)
+			{
+				if (pOccupant->IsOccupantGroup(item.first))
+				{
+					if (result)
+					{
+						destination.Append(separator.data(), static_cast<uint32_t>(separator.size()));
+					}
+
+					destination.Append(item.second.data(), static_cast<uint32_t>(item.second.size()));
+					result = true;
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+bool BuildingStyleCache::TryGetWallToWall(cISC4Occupant* pOccupant, bool& isWallToWall)
+{
+	if (!buildingStyleInfo)
+	{
+		if (!loggedMissingBuildingStyleInfo)
+		{
+			loggedMissingBuildingStyleInfo = true;
+
+			Logger::GetInstance().WriteLine(
+				LogLevel::Error,
+				"Unable to get the building W2W status. Install or update the MoreBuildingStyles DLL."
+				"(https://community.simtropolis.com/files/file/36112-allow-more-building-styles-dll-plugin/).");
+		}
+
+		return false;
+	}
+
+	if (!pOccupant)
+	{
+		return false;
+	}
+
+	isWallToWall = buildingStyleInfo->IsWallToWall(pOccupant);
+	return true;
+}
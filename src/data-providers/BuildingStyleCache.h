@@ -0,0 +1,71 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cIBuildingStyleInfo2.h"
+#include "cRZAutoRefCount.h"
+#include <cstdint>
+#include <string_view>
+
+class cIGZCOM;
+class cIGZString;
+class cISC4Occupant;
+
+/**
+ * @brief Caches the More Building Styles DLL interface for the lifetime of a city.
+ *
+ * The interface is resolved once per city instead of on every query. When that DLL
+ * is not installed, the building styles fall back to the 4 built-in Maxis styles.
+ * The formatted style names are cached by building type in BuildingTypeTokenCache.
+ */
+class BuildingStyleCache
+{
+public:
+	BuildingStyleCache();
+
+	void PostCityInit(cIGZCOM* pCOM);
+	void PreCityShutdown();
+
+	/**
+	 * @brief Appends the style names of the specified building to the destination.
+	 * @param pOccupant The building occupant.
+	 * @param separator The separator between the style names.
+	 * @param destination The destination string.
+	 * @return true if at least one style name was written; otherwise, false.
+	 */
+	bool AppendStyleNames(
+		cISC4Occupant* pOccupant,
+		std::string_view separator,
+		cIGZString& destination);
+
+	/**
+	 * @brief Gets a value indicating whether the specified building is wall to wall.
+	 * @param pOccupant The building occupant.
+	 * @param isWallToWall Receives the wall to wall status.
+	 * @return true if the status is known; otherwise, false if the More Building Styles
+	 * DLL is not installed.
+	 */
+	bool TryGetWallToWall(cISC4Occupant* pOccupant, bool& isWallToWall);
+
+private:
+	cRZAutoRefCount<cIBuildingStyleInfo2> buildingStyleInfo;
+	bool loggedMissingBuildingStyleInfo;
+};
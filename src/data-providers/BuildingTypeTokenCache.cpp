@@ -0,0 +1,135 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BuildingTypeTokenCache.h"
+#include "cIGZString.h"
+
+namespace
+{
+	uint64_t MakeCacheKey(uint32_t buildingType, uint32_t languageID)
+	{
+		return (static_cast<uint64_t>(languageID) << 32) | static_cast<uint64_t>(buildingType);
+	}
+}
+
+BuildingTypeTokenCache::CacheEntry::CacheEntry(uint64_t key)
+	: key(key),
+	  tokenValues()
+{
+}
+
+BuildingTypeTokenCache::BuildingTypeTokenCache(size_t capacity)
+	: capacity(capacity),
+	  entries(),
+	  entryIndex()
+{
+	entryIndex.reserve(capacity);
+}
+
+bool BuildingTypeTokenCache::TryGet(
+	uint32_t buildingType,
+	uint32_t languageID,
+	std::string_view token,
+	cIGZString& destination)
+{
+	CacheEntry* pEntry = Find(MakeCacheKey(buildingType, languageID));
+
+	if (pEntry)
+	{
+		for (const auto& item : pEntry->tokenValues)
+		{
+			if (item.first == token)
+			{
+				destination.FromChar(item.second.data(), static_cast<uint32_t>(item.second.size()));
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void BuildingTypeTokenCache::Add(
+	uint32_t buildingType,
+	uint32_t languageID,
+	std::string_view token,
+	const cIGZString& value)
+{
+	if (capacity == 0)
+	{
+		return;
+	}
+
+	const uint64_t key = MakeCacheKey(buildingType, languageID);
+
+	CacheEntry* pEntry = Find(key);
+
+	if (!pEntry)
+	{
+		if (entries.size() >= capacity)
+		{
+			// Evict the least recently used building type.
+			entryIndex.erase(entries.back().key);
+			entries.pop_back();
+		}
+
+		entries.emplace_front(key);
+		entryIndex.emplace(key, entries.begin());
+
+		pEntry = &entries.front();
+	}
+
+	const std::string_view valueAsStringView(value.Data(), value.Strlen());
+
+	for (auto& item : pEntry->tokenValues)
+	{
+		if (item.first == token)
+		{
+			item.second = valueAsStringView;
+			return;
+		}
+	}
+
+	pEntry->tokenValues.emplace_back(token, std::string(valueAsStringView));
+}
+
+void BuildingTypeTokenCache::Clear()
+{
+	entryIndex.clear();
+	entries.clear();
+}
+
+BuildingTypeTokenCache::CacheEntry* BuildingTypeTokenCache::Find(uint64_t key)
+{
+	CacheEntry* pEntry = nullptr;
+
+	auto it = entryIndex.find(key);
+
+	if (it != entryIndex.end())
+	{
+		// Move the entry to the front of the list to mark it as the most recently used.
+		entries.splice(entries.begin(), entries, it->second);
+
+		pEntry = &entries.front();
+	}
+
+	return pEntry;
+}
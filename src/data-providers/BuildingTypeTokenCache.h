@@ -0,0 +1,89 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class cIGZString;
+
+/**
+ * @brief A least recently used cache of the formatted query variable values that
+ * only depend on the building exemplar.
+ *
+ * The entries are keyed by the building type and the game's current language.
+ */
+class BuildingTypeTokenCache
+{
+public:
+	explicit BuildingTypeTokenCache(size_t capacity);
+
+	/**
+	 * @brief Copies the cached value of the specified token to the destination string.
+	 * @param buildingType The building type (exemplar instance id).
+	 * @param languageID The current language id.
+	 * @param token The token name. Must point to storage that lives for the duration of the process.
+	 * @param destination The destination string.
+	 * @return true if the token value was cached; otherwise, false.
+	 */
+	bool TryGet(
+		uint32_t buildingType,
+		uint32_t languageID,
+		std::string_view token,
+		cIGZString& destination);
+
+	/**
+	 * @brief Adds the formatted value of the specified token to the cache.
+	 * @param buildingType The building type (exemplar instance id).
+	 * @param languageID The current language id.
+	 * @param token The token name. Must point to storage that lives for the duration of the process.
+	 * @param value The formatted token value.
+	 */
+	void Add(
+		uint32_t buildingType,
+		uint32_t languageID,
+		std::string_view token,
+		const cIGZString& value);
+
+	void Clear();
+
+private:
+	struct CacheEntry
+	{
+		uint64_t key;
+		std::vector<std::pair<std::string_view, std::string>> tokenValues;
+
+		explicit CacheEntry(uint64_t key);
+	};
+
+	typedef std::list<CacheEntry> EntryList;
+
+	CacheEntry* Find(uint64_t key);
+
+	size_t capacity;
+	EntryList entries;
+	std::unordered_map<uint64_t, EntryList::iterator> entryIndex;
+};
@@ -0,0 +1,307 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LocaleNumberFormatter.h"
+#include "cIGZLanguageManager.h"
+#include "cIGZLanguageUtility.h"
+#include "cRZBaseString.h"
+#include "DebugUtil.h"
+#include "GlobalSC4InterfacePointers.h"
+#include <array>
+#include <limits>
+#include <string_view>
+
+namespace
+{
+	// The currency symbol/Simolean string is the UTF-8 encoding of the section symbol.
+	static const cRZBaseString CurrencySymbol("\xC2\xA7");
+
+	bool IsDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	// The range of values that the native formatter is used for, this covers the values
+	// that the query variables format. The game formats some values using 32-bit integer
+	// or double precision paths, so values outside this range are passed to the game.
+	static constexpr int64_t NativeFormatMinValue = -static_cast<int64_t>(std::numeric_limits<int32_t>::max());
+	static constexpr int64_t NativeFormatMaxValue = std::numeric_limits<int32_t>::max();
+
+	bool IsInNativeFormatRange(int64_t value)
+	{
+		return value >= NativeFormatMinValue && value <= NativeFormatMaxValue;
+	}
+
+	// The size of the stack buffer that the native formatter writes to. It fits the values in
+	// the native format range with the prefix, suffix and separators of the game's languages,
+	// a layout that does not fit is rejected when it is verified.
+	static constexpr size_t FormatBufferSize = 64;
+
+	// The sample values that the captured layout must reproduce exactly.
+	static constexpr std::array<int64_t, 14> VerificationValues =
+	{
+		0,
+		7,
+		42,
+		999,
+		1000,
+		12345,
+		999999,
+		1000000,
+		123456789,
+		-7,
+		-1000,
+		-123456789,
+		NativeFormatMinValue,
+		NativeFormatMaxValue,
+	};
+}
+
+LocaleNumberFormatter::LocaleNumberFormatter()
+	: hasLanguage(false),
+	  languageID(0),
+	  pLanguageUtility(nullptr),
+	  numberLayout(),
+	  moneyLayout()
+{
+}
+
+bool LocaleNumberFormatter::MakeNumberString(int64_t number, cIGZString& destination)
+{
+	if (!UpdateLanguage())
+	{
+		return false;
+	}
+
+	if (!numberLayout.valid || !IsInNativeFormatRange(number))
+	{
+		return FormatWithGame(pLanguageUtility, NumberType::Number, number, destination);
+	}
+
+	return FormatWithLayout(numberLayout, number, destination);
+}
+
+bool LocaleNumberFormatter::MakeMoneyString(int64_t number, cIGZString& destination)
+{
+	if (!UpdateLanguage())
+	{
+		return false;
+	}
+
+	if (!moneyLayout.valid || !IsInNativeFormatRange(number))
+	{
+		return FormatWithGame(pLanguageUtility, NumberType::Money, number, destination);
+	}
+
+	return FormatWithLayout(moneyLayout, number, destination);
+}
+
+void LocaleNumberFormatter::Reset()
+{
+	hasLanguage = false;
+	languageID = 0;
+	pLanguageUtility = nullptr;
+	numberLayout = NumberLayout();
+	moneyLayout = NumberLayout();
+}
+
+bool LocaleNumberFormatter::UpdateLanguage()
+{
+	if (!spLanguageManager)
+	{
+		return false;
+	}
+
+	const uint32_t currentLanguageID = spLanguageManager->GetCurrentLanguage();
+
+	if (!hasLanguage || currentLanguageID != languageID)
+	{
+		Reset();
+
+		pLanguageUtility = spLanguageManager->GetLanguageUtility(0);
+
+		if (!pLanguageUtility)
+		{
+			return false;
+		}
+
+		hasLanguage = true;
+		languageID = currentLanguageID;
+
+		if (CaptureLayout(pLanguageUtility, NumberType::Number, numberLayout))
+		{
+			numberLayout.valid = VerifyLayout(pLanguageUtility, NumberType::Number, numberLayout);
+		}
+
+		if (CaptureLayout(pLanguageUtility, NumberType::Money, moneyLayout))
+		{
+			moneyLayout.valid = VerifyLayout(pLanguageUtility, NumberType::Money, moneyLayout);
+		}
+
+#ifdef _DEBUG
+		DebugUtil::PrintLineToDebugOutputFormatted(
+			"LocaleNumberFormatter: language 0x%08x, native number format: %s, native money format: %s",
+			languageID,
+			numberLayout.valid ? "true" : "false",
+			moneyLayout.valid ? "true" : "false");
+#endif // _DEBUG
+	}
+
+	return pLanguageUtility != nullptr;
+}
+
+bool LocaleNumberFormatter::FormatWithGame(
+	cIGZLanguageUtility* pLanguageUtility,
+	NumberType type,
+	int64_t number,
+	cIGZString& destination)
+{
+	bool result = false;
+
+	if (type == NumberType::Number)
+	{
+		result = pLanguageUtility->MakeNumberString(number, destination);
+	}
+	else if (type == NumberType::Money)
+	{
+		result = pLanguageUtility->MakeMoneyString(number, destination, &CurrencySymbol);
+	}
+
+	return result;
+}
+
+bool LocaleNumberFormatter::FormatWithLayout(const NumberLayout& layout, int64_t number, cIGZString& destination)
+{
+	// The number is formatted on the stack and copied to the destination string in one call.
+	char buffer[FormatBufferSize];
+
+	const size_t length = NumberLayoutFormatter::Format(layout, number, buffer, sizeof(buffer));
+
+	return length > 0 && destination.FromChar(buffer, static_cast<uint32_t>(length));
+}
+
+bool LocaleNumberFormatter::CaptureLayout(cIGZLanguageUtility* pLanguageUtility, NumberType type, NumberLayout& layout)
+{
+	// The layout is captured from the formatted value of 1234567, which contains
+	// two digit groups. The verification step checks the other number lengths.
+
+	constexpr std::string_view ExpectedDigits = "1234567";
+
+	for (int64_t sign : { 1, -1 })
+	{
+		cRZBaseString formatted;
+
+		if (!FormatWithGame(pLanguageUtility, type, sign * 1234567, formatted))
+		{
+			return false;
+		}
+
+		const std::string_view text(formatted.Data(), formatted.Strlen());
+
+		const size_t firstDigit = text.find_first_of("0123456789");
+		const size_t lastDigit = text.find_last_of("0123456789");
+
+		if (firstDigit == std::string_view::npos)
+		{
+			return false;
+		}
+
+		const std::string_view prefix = text.substr(0, firstDigit);
+		const std::string_view suffix = text.substr(lastDigit + 1);
+		const std::string_view digits = text.substr(firstDigit, (lastDigit - firstDigit) + 1);
+
+		// The digits should be in the format 1<separator>234<separator>567.
+
+		if (digits.size() < ExpectedDigits.size() || digits.front() != '1')
+		{
+			return false;
+		}
+
+		const size_t separatorEnd = digits.find('2');
+
+		if (separatorEnd == std::string_view::npos)
+		{
+			return false;
+		}
+
+		const std::string_view separator = digits.substr(1, separatorEnd - 1);
+
+		for (char c : separator)
+		{
+			if (IsDigit(c))
+			{
+				return false;
+			}
+		}
+
+		if (sign > 0)
+		{
+			layout.positivePrefix = prefix;
+			layout.positiveSuffix = suffix;
+			layout.groupSeparator = separator;
+		}
+		else
+		{
+			if (separator != layout.groupSeparator)
+			{
+				return false;
+			}
+
+			layout.negativePrefix = prefix;
+			layout.negativeSuffix = suffix;
+		}
+	}
+
+	return true;
+}
+
+bool LocaleNumberFormatter::VerifyLayout(cIGZLanguageUtility* pLanguageUtility, NumberType type, const NumberLayout& layout)
+{
+	char nativeBuffer[FormatBufferSize];
+
+	for (int64_t value : VerificationValues)
+	{
+		cRZBaseString gameOutput;
+
+		if (!FormatWithGame(pLanguageUtility, type, value, gameOutput))
+		{
+			return false;
+		}
+
+		const size_t nativeLength = NumberLayoutFormatter::Format(layout, value, nativeBuffer, sizeof(nativeBuffer));
+		const std::string_view nativeOutput(nativeBuffer, nativeLength);
+
+		if (nativeLength == 0 || std::string_view(gameOutput.Data(), gameOutput.Strlen()) != nativeOutput)
+		{
+#ifdef _DEBUG
+			DebugUtil::PrintLineToDebugOutputFormatted(
+				"LocaleNumberFormatter: value %lld, game = '%s', native = '%.*s'",
+				static_cast<long long>(value),
+				gameOutput.ToChar(),
+				static_cast<int>(nativeOutput.size()),
+				nativeOutput.data());
+#endif // _DEBUG
+			return false;
+		}
+	}
+
+	return true;
+}
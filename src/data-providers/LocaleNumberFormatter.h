@@ -0,0 +1,70 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "NumberLayout.h"
+#include <cstdint>
+
+class cIGZLanguageUtility;
+class cIGZString;
+
+/**
+ * @brief Formats integers and money values using the game's number format for the
+ * current language, without calling the game's language utility for each value.
+ *
+ * The prefix, suffix and digit grouping separator are captured from the game's
+ * formatter once per language and checked against it using a set of sample values.
+ * If the game's output cannot be reproduced, the game's formatter is used instead.
+ */
+class LocaleNumberFormatter
+{
+public:
+	LocaleNumberFormatter();
+
+	bool MakeNumberString(int64_t number, cIGZString& destination);
+	bool MakeMoneyString(int64_t number, cIGZString& destination);
+
+	void Reset();
+
+private:
+	enum class NumberType
+	{
+		Number = 0,
+		Money
+	};
+
+	bool UpdateLanguage();
+
+	static bool FormatWithGame(
+		cIGZLanguageUtility* pLanguageUtility,
+		NumberType type,
+		int64_t number,
+		cIGZString& destination);
+	static bool FormatWithLayout(const NumberLayout& layout, int64_t number, cIGZString& destination);
+	static bool CaptureLayout(cIGZLanguageUtility* pLanguageUtility, NumberType type, NumberLayout& layout);
+	static bool VerifyLayout(cIGZLanguageUtility* pLanguageUtility, NumberType type, const NumberLayout& layout);
+
+	bool hasLanguage;
+	uint32_t languageID;
+	cIGZLanguageUtility* pLanguageUtility;
+	NumberLayout numberLayout;
+	NumberLayout moneyLayout;
+};
@@ -0,0 +1,143 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NumberLayout.h"
+#include <array>
+#include <cstring>
+
+namespace
+{
+	// A table of the two digit decimal strings from 00 to 99, this allows the
+	// number to be converted two digits at a time.
+	constexpr std::array<char, 200> MakeDigitPairTable()
+	{
+		std::array<char, 200> table{};
+
+		for (size_t i = 0; i < 100; i++)
+		{
+			table[i * 2] = static_cast<char>('0' + (i / 10));
+			table[(i * 2) + 1] = static_cast<char>('0' + (i % 10));
+		}
+
+		return table;
+	}
+
+	static constexpr std::array<char, 200> DigitPairs = MakeDigitPairTable();
+
+	// Writes the decimal digits of value to the end of the buffer and returns a
+	// pointer to the first digit.
+	char* WriteDigits(uint64_t value, char* bufferEnd)
+	{
+		char* ptr = bufferEnd;
+
+		while (value >= 100)
+		{
+			const size_t pairIndex = static_cast<size_t>(value % 100) * 2;
+			value /= 100;
+
+			ptr -= 2;
+			ptr[0] = DigitPairs[pairIndex];
+			ptr[1] = DigitPairs[pairIndex + 1];
+		}
+
+		if (value >= 10)
+		{
+			const size_t pairIndex = static_cast<size_t>(value) * 2;
+
+			ptr -= 2;
+			ptr[0] = DigitPairs[pairIndex];
+			ptr[1] = DigitPairs[pairIndex + 1];
+		}
+		else
+		{
+			--ptr;
+			*ptr = static_cast<char>('0' + value);
+		}
+
+		return ptr;
+	}
+
+	char* Append(char* destination, const char* source, size_t length)
+	{
+		std::memcpy(destination, source, length);
+		return destination + length;
+	}
+}
+
+NumberLayout::NumberLayout()
+	: positivePrefix(),
+	  positiveSuffix(),
+	  negativePrefix(),
+	  negativeSuffix(),
+	  groupSeparator(),
+	  valid(false)
+{
+}
+
+size_t NumberLayoutFormatter::Format(const NumberLayout& layout, int64_t number, char* buffer, size_t bufferSize)
+{
+	const bool negative = number < 0;
+	// The magnitude is computed using unsigned arithmetic to handle the minimum int64_t value.
+	const uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(number) : static_cast<uint64_t>(number);
+
+	// The largest uint64_t value has 20 digits.
+	char digitBuffer[20];
+	char* const digitBufferEnd = digitBuffer + sizeof(digitBuffer);
+
+	const char* const digits = WriteDigits(magnitude, digitBufferEnd);
+	const size_t digitCount = static_cast<size_t>(digitBufferEnd - digits);
+
+	const std::string& prefix = negative ? layout.negativePrefix : layout.positivePrefix;
+	const std::string& suffix = negative ? layout.negativeSuffix : layout.positiveSuffix;
+
+	const size_t separatorCount = (digitCount - 1) / 3;
+	const size_t length = prefix.size()
+		+ digitCount
+		+ (separatorCount * layout.groupSeparator.size())
+		+ suffix.size();
+
+	if (length > bufferSize)
+	{
+		return 0;
+	}
+
+	char* ptr = Append(buffer, prefix.data(), prefix.size());
+
+	// The first group has between 1 and 3 digits, the remaining groups have 3 digits.
+	size_t groupLength = digitCount % 3;
+
+	if (groupLength == 0)
+	{
+		groupLength = 3;
+	}
+
+	ptr = Append(ptr, digits, groupLength);
+
+	for (size_t i = groupLength; i < digitCount; i += 3)
+	{
+		ptr = Append(ptr, layout.groupSeparator.data(), layout.groupSeparator.size());
+		ptr = Append(ptr, digits + i, 3);
+	}
+
+	Append(ptr, suffix.data(), suffix.size());
+
+	return length;
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// The prefix, suffix and digit grouping separator of the game's number format.
+struct NumberLayout
+{
+	std::string positivePrefix;
+	std::string positiveSuffix;
+	std::string negativePrefix;
+	std::string negativeSuffix;
+	std::string groupSeparator;
+	bool valid;
+
+	NumberLayout();
+};
+
+// Formats integers using a NumberLayout, the digits are written in groups of three
+// from the least significant digit. This does not depend on the game so it can be
+// tested on any platform.
+namespace NumberLayoutFormatter
+{
+	/**
+	 * @brief Writes the formatted number to the buffer, the output is not null-terminated.
+	 * @param layout The number layout.
+	 * @param number The number to format.
+	 * @param buffer The destination buffer.
+	 * @param bufferSize The size of the destination buffer.
+	 * @return The length of the formatted number, or 0 if it does not fit in the buffer.
+	 */
+	size_t Format(const NumberLayout& layout, int64_t number, char* buffer, size_t bufferSize);
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OccupantSnapshotCache.h"
+
+OccupantSnapshotCache::CacheEntry::CacheEntry(cISC4Occupant* pOccupant, uint32_t languageID, uint32_t epoch)
+	: occupant(pOccupant),
+	  languageID(languageID),
+	  epoch(epoch),
+	  snapshot(std::make_shared<const BuildingOccupantSnapshot>(pOccupant))
+{
+}
+
+OccupantSnapshotCache::OccupantSnapshotCache(size_t capacity)
+	: capacity(capacity),
+	  entries(),
+	  entryIndex()
+{
+	entryIndex.reserve(capacity);
+}
+
+std::shared_ptr<const BuildingOccupantSnapshot> OccupantSnapshotCache::Get(
+	cISC4Occupant* pOccupant,
+	uint32_t languageID,
+	uint32_t epoch)
+{
+	if (capacity == 0 || !pOccupant)
+	{
+		return std::make_shared<const BuildingOccupantSnapshot>(pOccupant);
+	}
+
+	auto it = entryIndex.find(pOccupant);
+
+	if (it != entryIndex.end())
+	{
+		// Move the entry to the front of the list to mark it as the most recently used.
+		entries.splice(entries.begin(), entries, it->second);
+
+		CacheEntry& entry = entries.front();
+
+		if (entry.languageID != languageID || entry.epoch != epoch)
+		{
+			// The cached snapshot is stale, the entry is reused for the new snapshot.
+			entry.languageID = languageID;
+			entry.epoch = epoch;
+			entry.snapshot = std::make_shared<const BuildingOccupantSnapshot>(pOccupant);
+		}
+
+		return entry.snapshot;
+	}
+
+	if (entries.size() >= capacity)
+	{
+		// Evict the least recently used occupant.
+		entryIndex.erase(static_cast<cISC4Occupant*>(entries.back().occupant));
+		entries.pop_back();
+	}
+
+	entries.emplace_front(pOccupant, languageID, epoch);
+	entryIndex.emplace(pOccupant, entries.begin());
+
+	return entries.front().snapshot;
+}
+
+void OccupantSnapshotCache::Clear()
+{
+	entryIndex.clear();
+	entries.clear();
+}
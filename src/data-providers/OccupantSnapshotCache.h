@@ -0,0 +1,76 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BuildingOccupantSnapshot.h"
+#include "cISC4Occupant.h"
+#include "cRZAutoRefCount.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * @brief A least recently used cache of the occupant snapshots that the query
+ * variables, the expressions and the Lua extensions read.
+ *
+ * The entries are keyed by the occupant, a snapshot is rebuilt when the game's
+ * language or the simulation epoch changes.
+ * The cache holds a reference to each occupant, so it must be cleared before the
+ * city is unloaded.
+ */
+class OccupantSnapshotCache
+{
+public:
+	explicit OccupantSnapshotCache(size_t capacity);
+
+	/**
+	 * @brief Gets the snapshot of the specified occupant, creating it if it is not
+	 * cached or the cached snapshot is stale.
+	 * @param pOccupant The occupant.
+	 * @param languageID The current language id.
+	 * @param epoch The current simulation epoch.
+	 * @return The occupant snapshot. It stays valid after being evicted from the cache.
+	 */
+	std::shared_ptr<const BuildingOccupantSnapshot> Get(
+		cISC4Occupant* pOccupant,
+		uint32_t languageID,
+		uint32_t epoch);
+
+	void Clear();
+
+private:
+	struct CacheEntry
+	{
+		cRZAutoRefCount<cISC4Occupant> occupant;
+		uint32_t languageID;
+		uint32_t epoch;
+		std::shared_ptr<const BuildingOccupantSnapshot> snapshot;
+
+		CacheEntry(cISC4Occupant* pOccupant, uint32_t languageID, uint32_t epoch);
+	};
+
+	typedef std::list<CacheEntry> EntryList;
+
+	size_t capacity;
+	EntryList entries;
+	std::unordered_map<cISC4Occupant*, EntryList::iterator> entryIndex;
+};
@@ -0,0 +1,74 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PropertyNameDictionary.h"
+#include "frozen/string.h"
+#include "frozen/unordered_map.h"
+
+namespace
+{
+	// The lookup table is built at compile time, frozen::unordered_map uses a
+	// perfect hash so a name is resolved with a single probe.
+	static constexpr frozen::unordered_map<frozen::string, uint32_t, 28> propertyNames =
+	{
+		{ "Exemplar Type", 0x00000010 },
+		{ "Exemplar Name", 0x00000020 },
+		{ "Bulldoze Cost", 0x099AFACD },
+		{ "Occupant Size", 0x27812810 },
+		{ "Wealth", 0x27812832 },
+		{ "Purpose", 0x27812833 },
+		{ "Capacity Satisfied", 0x27812834 },
+		{ "Demand Satisfied", 0x27812840 },
+		{ "Landmark Effect", 0x2781284F },
+		{ "Park Effect", 0x27812850 },
+		{ "Pollution at center", 0x27812851 },
+		{ "Power Consumed", 0x27812854 },
+		{ "Flammability", 0x29244DB5 },
+		{ "Query Exemplar GUID", 0x2A499F85 },
+		{ "Water Source", 0x48F23A7E },
+		{ "Max Fire Stage", 0x49BEDA31 },
+		{ "Pollution radii", 0x68EE9764 },
+		{ "OccupantGroups", 0xAA1DD396 },
+		{ "Water Consumed", 0xC8ED2D84 },
+		{ "Mayor Rating Effect", 0xCA5B9305 },
+		{ "Crime Effect", 0xCA5B9306 },
+		{ "Budget Item: Department", 0xEA54D283 },
+		{ "Budget Item: Line", 0xEA54D284 },
+		{ "Budget Item: Purpose", 0xEA54D285 },
+		{ "Budget Item: Cost", 0xEA54D286 },
+		{ "Item Icon", 0x8A2602B8 },
+		{ "Item Order", 0x8A2602B9 },
+		{ "User Visible Name Key", 0x8A416A99 },
+	};
+}
+
+bool PropertyNameDictionary::TryGetPropertyID(std::string_view const& name, uint32_t& propertyID)
+{
+	const auto& entry = propertyNames.find(frozen::string(name));
+
+	if (entry != propertyNames.end())
+	{
+		propertyID = entry->second;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,473 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "QueryExpression.h"
+#include <array>
+#include <charconv>
+
+namespace
+{
+	bool IsIdentifierStart(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+	}
+
+	bool IsIdentifierChar(char c)
+	{
+		return IsIdentifierStart(c) || (c >= '0' && c <= '9');
+	}
+
+	bool IsNumberStart(char c)
+	{
+		return (c >= '0' && c <= '9') || c == '.';
+	}
+}
+
+class QueryExpression::Parser
+{
+public:
+	Parser(std::string_view const& text, SourceResolver resolver, std::vector<Instruction>& instructions)
+		: text(text),
+		  position(0),
+		  resolver(resolver),
+		  instructions(instructions),
+		  stackDepth(0),
+		  nestingDepth(0)
+	{
+	}
+
+	bool ParseExpression()
+	{
+		return ParseComparison();
+	}
+
+	bool Match(char c)
+	{
+		SkipWhitespace();
+
+		if (position < text.size() && text[position] == c)
+		{
+			position++;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool AtEnd()
+	{
+		SkipWhitespace();
+
+		return position == text.size();
+	}
+
+	bool EmitAdd()
+	{
+		return Emit(OpCode::Add);
+	}
+
+private:
+	// Limits the parenthesis and unary minus nesting to keep the parser recursion bounded.
+	static constexpr size_t MaxNestingDepth = 32;
+
+	void SkipWhitespace()
+	{
+		while (position < text.size() && (text[position] == ' ' || text[position] == '\t'))
+		{
+			position++;
+		}
+	}
+
+	bool Emit(OpCode op, double constant = 0.0, Source source = Source{})
+	{
+		switch (op)
+		{
+		case OpCode::PushConstant:
+		case OpCode::PushSource:
+			if (stackDepth == MaxStackDepth)
+			{
+				return false;
+			}
+			stackDepth++;
+			break;
+		case OpCode::Negate:
+			break;
+		default:
+			// The binary operators replace their two operands with the result.
+			stackDepth--;
+			break;
+		}
+
+		instructions.push_back(Instruction{ op, constant, source });
+		return true;
+	}
+
+	bool ParseComparison()
+	{
+		if (!ParseAdditive())
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+
+		const std::string_view remaining = text.substr(position);
+		OpCode op = OpCode::PushConstant;
+		size_t length = 0;
+
+		if (remaining.starts_with("=="))
+		{
+			op = OpCode::Equal;
+			length = 2;
+		}
+		else if (remaining.starts_with("!="))
+		{
+			op = OpCode::NotEqual;
+			length = 2;
+		}
+		else if (remaining.starts_with("<="))
+		{
+			op = OpCode::LessOrEqual;
+			length = 2;
+		}
+		else if (remaining.starts_with(">="))
+		{
+			op = OpCode::GreaterOrEqual;
+			length = 2;
+		}
+		else if (remaining.starts_with("<"))
+		{
+			op = OpCode::Less;
+			length = 1;
+		}
+		else if (remaining.starts_with(">"))
+		{
+			op = OpCode::Greater;
+			length = 1;
+		}
+
+		if (length > 0)
+		{
+			position += length;
+
+			if (!ParseAdditive())
+			{
+				return false;
+			}
+
+			return Emit(op);
+		}
+
+		return true;
+	}
+
+	bool ParseAdditive()
+	{
+		if (!ParseTerm())
+		{
+			return false;
+		}
+
+		while (true)
+		{
+			OpCode op;
+
+			if (Match('+'))
+			{
+				op = OpCode::Add;
+			}
+			else if (Match('-'))
+			{
+				op = OpCode::Subtract;
+			}
+			else
+			{
+				break;
+			}
+
+			if (!ParseTerm() || !Emit(op))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ParseTerm()
+	{
+		if (!ParseUnary())
+		{
+			return false;
+		}
+
+		while (true)
+		{
+			OpCode op;
+
+			if (Match('*'))
+			{
+				op = OpCode::Multiply;
+			}
+			else if (Match('/'))
+			{
+				op = OpCode::Divide;
+			}
+			else
+			{
+				break;
+			}
+
+			if (!ParseUnary() || !Emit(op))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ParseUnary()
+	{
+		if (Match('-'))
+		{
+			if (nestingDepth == MaxNestingDepth)
+			{
+				return false;
+			}
+
+			nestingDepth++;
+
+			const bool result = ParseUnary() && Emit(OpCode::Negate);
+
+			nestingDepth--;
+			return result;
+		}
+
+		return ParsePrimary();
+	}
+
+	bool ParsePrimary()
+	{
+		SkipWhitespace();
+
+		if (position == text.size())
+		{
+			return false;
+		}
+
+		const char c = text[position];
+
+		if (c == '(')
+		{
+			if (nestingDepth == MaxNestingDepth)
+			{
+				return false;
+			}
+
+			position++;
+			nestingDepth++;
+
+			const bool result = ParseExpression() && Match(')');
+
+			nestingDepth--;
+			return result;
+		}
+		else if (IsNumberStart(c))
+		{
+			double value = 0.0;
+
+			const char* start = text.data() + position;
+			const char* end = text.data() + text.size();
+
+			const auto result = std::from_chars(start, end, value);
+
+			if (result.ec != std::errc{})
+			{
+				return false;
+			}
+
+			position += static_cast<size_t>(result.ptr - start);
+
+			return Emit(OpCode::PushConstant, value);
+		}
+		else if (IsIdentifierStart(c))
+		{
+			const size_t start = position;
+
+			while (position < text.size() && IsIdentifierChar(text[position]))
+			{
+				position++;
+			}
+
+			Source source{};
+
+			if (!resolver(text.substr(start, position - start), source))
+			{
+				return false;
+			}
+
+			return Emit(OpCode::PushSource, 0.0, source);
+		}
+
+		return false;
+	}
+
+	std::string_view text;
+	size_t position;
+	SourceResolver resolver;
+	std::vector<Instruction>& instructions;
+	size_t stackDepth;
+	size_t nestingDepth;
+};
+
+QueryExpression::QueryExpression()
+	: instructions()
+{
+}
+
+bool QueryExpression::Compile(std::string_view const& text, SourceResolver resolver)
+{
+	instructions.clear();
+
+	Parser parser(text, resolver, instructions);
+
+	if (!parser.ParseExpression() || !parser.AtEnd())
+	{
+		instructions.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool QueryExpression::CompileSum(std::string_view const& text, SourceResolver resolver)
+{
+	instructions.clear();
+
+	Parser parser(text, resolver, instructions);
+
+	if (!parser.ParseExpression())
+	{
+		instructions.clear();
+		return false;
+	}
+
+	while (parser.Match(','))
+	{
+		if (!parser.ParseExpression())
+		{
+			instructions.clear();
+			return false;
+		}
+
+		// Adds the item value to the running total.
+		parser.EmitAdd();
+	}
+
+	if (!parser.AtEnd())
+	{
+		instructions.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool QueryExpression::Evaluate(SourceReader reader, const void* pContext, double& value) const
+{
+	if (instructions.empty())
+	{
+		return false;
+	}
+
+	std::array<double, MaxStackDepth> stack{};
+	size_t count = 0;
+
+	for (const Instruction& instruction : instructions)
+	{
+		switch (instruction.op)
+		{
+		case OpCode::PushConstant:
+			stack[count++] = instruction.constant;
+			break;
+		case OpCode::PushSource:
+			if (!reader(instruction.source, pContext, stack[count]))
+			{
+				return false;
+			}
+			count++;
+			break;
+		case OpCode::Negate:
+			stack[count - 1] = -stack[count - 1];
+			break;
+		default:
+		{
+			const double right = stack[--count];
+			double& left = stack[count - 1];
+
+			switch (instruction.op)
+			{
+			case OpCode::Add:
+				left += right;
+				break;
+			case OpCode::Subtract:
+				left -= right;
+				break;
+			case OpCode::Multiply:
+				left *= right;
+				break;
+			case OpCode::Divide:
+				if (right == 0.0)
+				{
+					return false;
+				}
+				left /= right;
+				break;
+			case OpCode::Equal:
+				left = left == right ? 1.0 : 0.0;
+				break;
+			case OpCode::NotEqual:
+				left = left != right ? 1.0 : 0.0;
+				break;
+			case OpCode::Less:
+				left = left < right ? 1.0 : 0.0;
+				break;
+			case OpCode::LessOrEqual:
+				left = left <= right ? 1.0 : 0.0;
+				break;
+			case OpCode::Greater:
+				left = left > right ? 1.0 : 0.0;
+				break;
+			case OpCode::GreaterOrEqual:
+				left = left >= right ? 1.0 : 0.0;
+				break;
+			default:
+				return false;
+			}
+			break;
+		}
+		}
+	}
+
+	value = stack[0];
+	return true;
+}
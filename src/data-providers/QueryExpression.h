@@ -0,0 +1,110 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A numeric expression that is compiled once into a small stack-based
+ * bytecode and then evaluated against the query variable values.
+ *
+ * The expressions support numbers, named values, parentheses, unary minus,
+ * the + - * / operators and the == != < <= > >= comparisons, which evaluate
+ * to 1 or 0.
+ * The named values are resolved to sources when the expression is compiled,
+ * so evaluating an expression does not perform any string processing.
+ */
+class QueryExpression
+{
+public:
+	struct Source
+	{
+		uint32_t type;
+		uint32_t argument;
+	};
+
+	typedef bool (*SourceResolver)(std::string_view const& name, Source& source);
+	typedef bool (*SourceReader)(Source const& source, const void* pContext, double& value);
+
+	QueryExpression();
+
+	/**
+	 * @brief Compiles the specified expression text.
+	 * @param text The expression text, e.g. r1_occupancy/r1_capacity.
+	 * @param resolver The method that resolves the named values.
+	 * @return True if the expression was compiled; otherwise, false.
+	 */
+	bool Compile(std::string_view const& text, SourceResolver resolver);
+
+	/**
+	 * @brief Compiles a comma-separated list of expressions that evaluates
+	 * to the sum of the list items.
+	 * @param text The expression list text, e.g. jobs_low_wealth,jobs_medium_wealth.
+	 * @param resolver The method that resolves the named values.
+	 * @return True if the expression list was compiled; otherwise, false.
+	 */
+	bool CompileSum(std::string_view const& text, SourceResolver resolver);
+
+	/**
+	 * @brief Evaluates the compiled expression.
+	 * @param reader The method that reads the values of the sources.
+	 * @param pContext The context value that is passed to the reader.
+	 * @param value On success, receives the expression value.
+	 * @return True if the expression was evaluated; otherwise, false, e.g. when
+	 * the expression divides by zero or a source can't be read.
+	 */
+	bool Evaluate(SourceReader reader, const void* pContext, double& value) const;
+
+private:
+	enum class OpCode : uint8_t
+	{
+		PushConstant = 0,
+		PushSource,
+		Negate,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Equal,
+		NotEqual,
+		Less,
+		LessOrEqual,
+		Greater,
+		GreaterOrEqual
+	};
+
+	struct Instruction
+	{
+		OpCode op;
+		double constant;
+		Source source;
+	};
+
+	class Parser;
+
+	// The evaluation stack has a fixed size, expressions that would
+	// need a deeper stack are rejected when they are compiled.
+	static constexpr size_t MaxStackDepth = 16;
+
+	std::vector<Instruction> instructions;
+};
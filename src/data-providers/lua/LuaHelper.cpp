@@ -106,3 +106,97 @@ void LuaHelper::SetResultFromIGZVariant(cISCLua* pLua, const cIGZVariant* pVaria
 		break;
 	}
 }
+
+namespace
+{
+	template <typename T>
+	void PushArrayElementValue(cISCLua* pLua, const T* values, uint32_t count, uint32_t index)
+	{
+		if (values && index < count)
+		{
+			LuaHelper::PushValue(pLua, values[index]);
+		}
+		else
+		{
+			pLua->PushNil();
+		}
+	}
+}
+
+bool LuaHelper::IsSupportedArrayType(const cIGZVariant* pVariant)
+{
+	bool result = false;
+
+	if (pVariant)
+	{
+		switch (static_cast<cIGZVariant::Type>(pVariant->GetType()))
+		{
+		case cIGZVariant::Type::BoolArray:
+		case cIGZVariant::Type::Uint8Array:
+		case cIGZVariant::Type::Sint8Array:
+		case cIGZVariant::Type::Uint16Array:
+		case cIGZVariant::Type::Sint16Array:
+		case cIGZVariant::Type::Uint32Array:
+		case cIGZVariant::Type::Sint32Array:
+		case cIGZVariant::Type::Uint64Array:
+		case cIGZVariant::Type::Sint64Array:
+		case cIGZVariant::Type::Float32Array:
+		case cIGZVariant::Type::Float64Array:
+			result = true;
+			break;
+		}
+	}
+
+	return result;
+}
+
+void LuaHelper::PushArrayElement(cISCLua* pLua, const cIGZVariant* pVariant, uint32_t index)
+{
+	if (!pVariant)
+	{
+		pLua->PushNil();
+		return;
+	}
+
+	const uint32_t count = pVariant->GetCount();
+
+	switch (static_cast<cIGZVariant::Type>(pVariant->GetType()))
+	{
+	case cIGZVariant::Type::BoolArray:
+		PushArrayElementValue(pLua, pVariant->RefBool(), count, index);
+		break;
+	case cIGZVariant::Type::Uint8Array:
+		PushArrayElementValue(pLua, pVariant->RefUint8(), count, index);
+		break;
+	case cIGZVariant::Type::Sint8Array:
+		PushArrayElementValue(pLua, pVariant->RefSint8(), count, index);
+		break;
+	case cIGZVariant::Type::Uint16Array:
+		PushArrayElementValue(pLua, pVariant->RefUint16(), count, index);
+		break;
+	case cIGZVariant::Type::Sint16Array:
+		PushArrayElementValue(pLua, pVariant->RefSint16(), count, index);
+		break;
+	case cIGZVariant::Type::Uint32Array:
+		PushArrayElementValue(pLua, pVariant->RefUint32(), count, index);
+		break;
+	case cIGZVariant::Type::Sint32Array:
+		PushArrayElementValue(pLua, pVariant->RefSint32(), count, index);
+		break;
+	case cIGZVariant::Type::Uint64Array:
+		PushArrayElementValue(pLua, pVariant->RefUint64(), count, index);
+		break;
+	case cIGZVariant::Type::Sint64Array:
+		PushArrayElementValue(pLua, pVariant->RefSint64(), count, index);
+		break;
+	case cIGZVariant::Type::Float32Array:
+		PushArrayElementValue(pLua, pVariant->RefFloat32(), count, index);
+		break;
+	case cIGZVariant::Type::Float64Array:
+		PushArrayElementValue(pLua, pVariant->RefFloat64(), count, index);
+		break;
+	default:
+		pLua->PushNil();
+		break;
+	}
+}
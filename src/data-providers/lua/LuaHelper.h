@@ -151,4 +151,21 @@ namespace LuaHelper
 	}
 
 	void SetResultFromIGZVariant(cISCLua* pLua, const cIGZVariant* pVariant);
+
+	/**
+	 * @brief Determines if the variant is a numeric or boolean array that can be
+	 * read with PushArrayElement.
+	 * @param pVariant The variant.
+	 * @return True if the variant is a supported array type; otherwise, false.
+	 */
+	bool IsSupportedArrayType(const cIGZVariant* pVariant);
+
+	/**
+	 * @brief Pushes a single element of a numeric or boolean array variant onto the stack.
+	 * Nil is pushed if the variant is not a supported array type or the index is out of range.
+	 * @param pLua The Lua instance.
+	 * @param pVariant The variant.
+	 * @param index The zero-based index of the element.
+	 */
+	void PushArrayElement(cISCLua* pLua, const cIGZVariant* pVariant, uint32_t index);
 }
\ No newline at end of file
@@ -20,6 +20,7 @@
  */
 
 #include "QueryUILuaExtensions.h"
+#include "BuildingOccupantSnapshot.h"
 #include "cISCLua.h"
 #include "cISCProperty.h"
 #include "cISCPropertyHolder.h"
@@ -33,16 +34,92 @@
 #include "Logger.h"
 #include "SCLuaUtil.h"
 #include "QueryUILuaExtensionsTest.h"
+#include "PropertyNameDictionary.h"
+
+#include <array>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace
 {
-	static cISC4Occupant* spOccupant = nullptr;
+	static const BuildingOccupantSnapshot* spOccupantSnapshot = nullptr;
+	// The generation of the current snapshot, this is used to detect array views
+	// that were created for a dialog that has been closed.
+	static uint32_t sSnapshotGeneration = 0;
+	// The last generation that was assigned, each dialog gets a new generation.
+	static uint32_t sLastSnapshotGeneration = 0;
+
+	// The query dialog can be opened again while it is being shown, e.g. by the Lua
+	// window_query function. The snapshot and generation of each open dialog are saved
+	// so that the outer dialog's array views remain valid when a nested dialog is closed.
+	struct DialogSnapshot
+	{
+		const BuildingOccupantSnapshot* pSnapshot;
+		uint32_t generation;
+	};
+
+	static std::vector<DialogSnapshot> sDialogSnapshots;
+
+	// The Lua 5.0 LUA_REGISTRYINDEX pseudo-index.
+	static constexpr int32_t LuaRegistryIndex = -10000;
+
+	// The registry key of the metatable that is shared by every array view.
+	static constexpr std::string_view PropertyArrayViewMetaTableKey = "null45_query_ui_extensions.property_array_view";
+
+	// The userdata value of an array view.
+	// The variant is owned by the occupant, it is only accessed while the
+	// generation matches the current snapshot.
+	struct PropertyArrayView
+	{
+		const cIGZVariant* pVariant;
+		uint32_t generation;
+	};
+
+	void SetCurrentDialogSnapshot()
+	{
+		if (sDialogSnapshots.empty())
+		{
+			// The views of the closed dialogs must not match the generation that is used
+			// while no dialog is open.
+			spOccupantSnapshot = nullptr;
+			sSnapshotGeneration = ++sLastSnapshotGeneration;
+		}
+		else
+		{
+			spOccupantSnapshot = sDialogSnapshots.back().pSnapshot;
+			sSnapshotGeneration = sDialogSnapshots.back().generation;
+		}
+	}
+
+	void PushOccupantSnapshot(const BuildingOccupantSnapshot* pSnapshot)
+	{
+		sDialogSnapshots.push_back(DialogSnapshot{ pSnapshot, ++sLastSnapshotGeneration });
+		SetCurrentDialogSnapshot();
+	}
+
+	void PopOccupantSnapshot()
+	{
+		if (!sDialogSnapshots.empty())
+		{
+			sDialogSnapshots.pop_back();
+		}
+
+		SetCurrentDialogSnapshot();
+	}
+
+	void ClearOccupantSnapshots()
+	{
+		sDialogSnapshots.clear();
+		SetCurrentDialogSnapshot();
+	}
 
 	int32_t get_property_value(lua_State* pState)
 	{
 		cRZAutoRefCount<cISCLua> lua = SCLuaUtil::GetISCLuaFromFunctionState(pState);
 
-		if (spOccupant)
+		if (spOccupantSnapshot && spOccupantSnapshot->GetPropertyHolder())
 		{
 			const int32_t parameterCount = lua->GetTop();
 
@@ -50,7 +127,46 @@ namespace
 
 			if (parameterCount == 1 && LuaHelper::GetNumber(lua, 1, propertyID))
 			{
-				const cISCPropertyHolder* pPropertyHolder = spOccupant->AsPropertyHolder();
+				const cISCPropertyHolder* pPropertyHolder = spOccupantSnapshot->GetPropertyHolder();
+				const cISCProperty* pProperty = pPropertyHolder->GetProperty(propertyID);
+
+				if (pProperty)
+				{
+					LuaHelper::SetResultFromIGZVariant(lua, pProperty->GetPropertyValue());
+				}
+				else
+				{
+					lua->PushNil();
+				}
+			}
+			else
+			{
+				lua->PushNil();
+			}
+		}
+		else
+		{
+			lua->PushNil();
+		}
+
+		return 1;
+	}
+
+	int32_t get_property_value_by_name(lua_State* pState)
+	{
+		cRZAutoRefCount<cISCLua> lua = SCLuaUtil::GetISCLuaFromFunctionState(pState);
+
+		if (spOccupantSnapshot && spOccupantSnapshot->GetPropertyHolder())
+		{
+			const int32_t parameterCount = lua->GetTop();
+
+			uint32_t propertyID = 0;
+
+			if (parameterCount == 1
+				&& lua->IsString(1)
+				&& PropertyNameDictionary::TryGetPropertyID(std::string_view(lua->ToString(1), lua->Strlen(1)), propertyID))
+			{
+				const cISCPropertyHolder* pPropertyHolder = spOccupantSnapshot->GetPropertyHolder();
 				const cISCProperty* pProperty = pPropertyHolder->GetProperty(propertyID);
 
 				if (pProperty)
@@ -74,9 +190,450 @@ namespace
 
 		return 1;
 	}
+
+	int32_t get_property_values(lua_State* pState)
+	{
+		cRZAutoRefCount<cISCLua> lua = SCLuaUtil::GetISCLuaFromFunctionState(pState);
+
+		if (spOccupantSnapshot && spOccupantSnapshot->GetPropertyHolder())
+		{
+			const int32_t parameterCount = lua->GetTop();
+
+			if (parameterCount == 1 && lua->IsTable(1))
+			{
+				const cISCPropertyHolder* pPropertyHolder = spOccupantSnapshot->GetPropertyHolder();
+
+				// The result table is keyed by the property id, properties that do not
+				// exist are omitted from the table.
+				lua->NewTable();
+
+				// Lua uses a one-based index for arrays.
+				for (int32_t i = 1; ; i++)
+				{
+					lua->RawGetI(1, i);
+
+					if (lua->IsNil(-1))
+					{
+						lua->Pop(1);
+						break;
+					}
+
+					uint32_t propertyID = 0;
+					const bool validPropertyID = LuaHelper::GetNumber(lua, -1, propertyID);
+					lua->Pop(1);
+
+					if (validPropertyID)
+					{
+						const cISCProperty* pProperty = pPropertyHolder->GetProperty(propertyID);
+
+						if (pProperty)
+						{
+							LuaHelper::PushValue(lua, propertyID);
+							LuaHelper::SetResultFromIGZVariant(lua, pProperty->GetPropertyValue());
+							lua->RawSet(-3);
+						}
+					}
+				}
+			}
+			else
+			{
+				lua->PushNil();
+			}
+		}
+		else
+		{
+			lua->PushNil();
+		}
+
+		return 1;
+	}
+
+	const cIGZVariant* GetArrayViewVariant(cISCLua* lua, int32_t index)
+	{
+		const cIGZVariant* pVariant = nullptr;
+
+		const PropertyArrayView* pView = static_cast<const PropertyArrayView*>(lua->ToUserData(index));
+
+		if (pView && pView->generation == sSnapshotGeneration && spOccupantSnapshot)
+		{
+			pVariant = pView->pVariant;
+		}
+
+		return pVariant;
+	}
+
+	int32_t property_array_view_index(lua_State* pState)
+	{
+		cRZAutoRefCount<cISCLua> lua = SCLuaUtil::GetISCLuaFromFunctionState(pState);
+
+		// The __index metamethod is called with the view and the key.
+		const cIGZVariant* pVariant = GetArrayViewVariant(lua, 1);
+
+		if (pVariant)
+		{
+			if (lua->IsNumber(2))
+			{
+				uint32_t index = 0;
+
+				// Lua uses a one-based index for arrays.
+				if (LuaHelper::GetNumber(lua, 2, index) && index > 0)
+				{
+					LuaHelper::PushArrayElement(lua, pVariant, index - 1);
+				}
+				else
+				{
+					lua->PushNil();
+				}
+			}
+			else if (lua->IsString(2) && std::string_view(lua->ToString(2), lua->Strlen(2)) == "n")
+			{
+				// Lua 5.0 does not support a __len metamethod and its getn function only
+				// accepts tables, so callers read the element count from the n field.
+				LuaHelper::PushValue(lua, pVariant->GetCount());
+			}
+			else
+			{
+				lua->PushNil();
+			}
+		}
+		else
+		{
+			lua->PushNil();
+		}
+
+		return 1;
+	}
+
+	// Pushes the array view metatable onto the stack, the metatable is created on
+	// first use and kept in the registry for the lifetime of the Lua state.
+	void PushPropertyArrayViewMetaTable(cISCLua* lua)
+	{
+		lua->PushLString(PropertyArrayViewMetaTableKey.data(), PropertyArrayViewMetaTableKey.size());
+		lua->RawGet(LuaRegistryIndex);
+
+		if (lua->IsNil(-1))
+		{
+			lua->Pop(1);
+
+			lua->NewTable();
+			lua->PushLString("__index", 7);
+			lua->PushCFunction(&property_array_view_index);
+			lua->RawSet(-3);
+
+			lua->PushLString(PropertyArrayViewMetaTableKey.data(), PropertyArrayViewMetaTableKey.size());
+			lua->PushValue(-2);
+			lua->RawSet(LuaRegistryIndex);
+		}
+	}
+
+	int32_t get_property_array_view(lua_State* pState)
+	{
+		cRZAutoRefCount<cISCLua> lua = SCLuaUtil::GetISCLuaFromFunctionState(pState);
+
+		const cIGZVariant* pVariant = nullptr;
+
+		if (spOccupantSnapshot && spOccupantSnapshot->GetPropertyHolder())
+		{
+			const int32_t parameterCount = lua->GetTop();
+
+			uint32_t propertyID = 0;
+
+			if (parameterCount == 1 && LuaHelper::GetNumber(lua, 1, propertyID))
+			{
+				const cISCPropertyHolder* pPropertyHolder = spOccupantSnapshot->GetPropertyHolder();
+				const cISCProperty* pProperty = pPropertyHolder->GetProperty(propertyID);
+
+				if (pProperty)
+				{
+					pVariant = pProperty->GetPropertyValue();
+				}
+			}
+		}
+
+		if (LuaHelper::IsSupportedArrayType(pVariant))
+		{
+			void* pUserData = lua->NewUserData(sizeof(PropertyArrayView));
+			new (pUserData) PropertyArrayView{ pVariant, sSnapshotGeneration };
+
+			PushPropertyArrayViewMetaTable(lua);
+			lua->SetMetaTable(-2);
+		}
+		else
+		{
+			lua->PushNil();
+		}
+
+		return 1;
+	}
+
+	// The hidden global table that holds the occupant proxy of each open dialog, it is
+	// indexed by the dialog nesting depth. The outer dialog keeps using its own proxy
+	// and the values that it cached after a nested dialog is closed.
+	static constexpr const char* OccupantProxiesGlobalName = "__null45_query_ui_extensions_occupant_proxies";
+
+	// Gets the snapshot generation that is stored in the metatable of the proxy at the
+	// specified stack index, or 0 if the value is not a proxy.
+	uint32_t GetOccupantProxyGeneration(cISCLua* lua, int32_t index)
+	{
+		uint32_t generation = 0;
+
+		if (lua->GetMetaTable(index))
+		{
+			lua->PushLString("generation", 10);
+			lua->RawGet(-2);
+			LuaHelper::GetNumber(lua, -1, generation);
+			lua->Pop(2);
+		}
+
+		return generation;
+	}
+
+	bool GetOccupantProxyPropertyID(cISCLua* lua, int32_t index, uint32_t& propertyID)
+	{
+		bool result = false;
+
+		if (lua->IsNumber(index))
+		{
+			result = LuaHelper::GetNumber(lua, index, propertyID);
+		}
+		else if (lua->IsString(index))
+		{
+			result = PropertyNameDictionary::TryGetPropertyID(
+				std::string_view(lua->ToString(index), lua->Strlen(index)),
+				propertyID);
+		}
+
+		return result;
+	}
+
+	int32_t occupant_proxy_index(lua_State* pState)
+	{
+		cRZAutoRefCount<cISCLua> lua = SCLuaUtil::GetISCLuaFromFunctionState(pState);
+
+		// The __index metamethod is called with the proxy and the key, it is only called
+		// for keys that are not already stored in the proxy.
+		// The proxy generation is stored in its metatable, a proxy that was created
+		// for a previous dialog must not read the properties of the current occupant.
+
+		uint32_t propertyID = 0;
+
+		if (GetOccupantProxyGeneration(lua, 1) == sSnapshotGeneration
+			&& spOccupantSnapshot
+			&& spOccupantSnapshot->GetPropertyHolder()
+			&& GetOccupantProxyPropertyID(lua, 2, propertyID))
+		{
+			const cISCPropertyHolder* pPropertyHolder = spOccupantSnapshot->GetPropertyHolder();
+			const cISCProperty* pProperty = pPropertyHolder->GetProperty(propertyID);
+
+			if (pProperty)
+			{
+				LuaHelper::SetResultFromIGZVariant(lua, pProperty->GetPropertyValue());
+
+				// Store the converted value in the proxy, later reads of the same
+				// key will be plain table lookups that do not call this function.
+				lua->PushValue(2);
+				lua->PushValue(-2);
+				lua->RawSet(1);
+			}
+			else
+			{
+				// Missing properties are not stored, nil can't be a table value.
+				lua->PushNil();
+			}
+		}
+		else
+		{
+			lua->PushNil();
+		}
+
+		return 1;
+	}
+
+	int32_t occupant(lua_State* pState)
+	{
+		cRZAutoRefCount<cISCLua> lua = SCLuaUtil::GetISCLuaFromFunctionState(pState);
+
+		if (spOccupantSnapshot)
+		{
+			const int32_t dialogDepth = static_cast<int32_t>(sDialogSnapshots.size());
+
+			lua->GetGlobal(OccupantProxiesGlobalName);
+
+			if (!lua->IsTable(-1))
+			{
+				lua->Pop(1);
+				lua->NewTable();
+				lua->PushValue(-1);
+				lua->SetGlobal(OccupantProxiesGlobalName);
+			}
+
+			lua->RawGetI(-1, dialogDepth);
+
+			if (GetOccupantProxyGeneration(lua, lua->GetTop()) != sSnapshotGeneration)
+			{
+				// The proxy is created once per dialog, the values that it caches are
+				// discarded when the dialog is closed.
+
+				lua->Pop(1);
+				lua->NewTable();
+
+				lua->NewTable();
+				lua->PushLString("__index", 7);
+				lua->PushCFunction(&occupant_proxy_index);
+				lua->RawSet(-3);
+				lua->PushLString("generation", 10);
+				LuaHelper::PushValue(lua, sSnapshotGeneration);
+				lua->RawSet(-3);
+				lua->SetMetaTable(-2);
+
+				lua->PushValue(-1);
+				lua->RawSetI(-3, dialogDepth);
+			}
+
+			// The proxy is the top value, the proxies table below it is discarded.
+		}
+		else
+		{
+			lua->PushNil();
+		}
+
+		return 1;
+	}
+
+	using DeveloperType = BuildingOccupantSnapshot::DeveloperType;
+	using WealthType = BuildingOccupantSnapshot::WealthType;
+
+	struct DeveloperTypeName
+	{
+		const char* name;
+		DeveloperType type;
+	};
+
+	// The developer type names match the names used by the occupancy: and capacity: query variables.
+	static constexpr std::array<DeveloperTypeName, 12> LotStatsDeveloperTypes =
+	{
+		DeveloperTypeName{ "r1", DeveloperType::ResidentialLowWealth },
+		DeveloperTypeName{ "r2", DeveloperType::ResidentialMediumWealth },
+		DeveloperTypeName{ "r3", DeveloperType::ResidentialHighWealth },
+		DeveloperTypeName{ "cs1", DeveloperType::CommercialServicesLowWealth },
+		DeveloperTypeName{ "cs2", DeveloperType::CommercialServicesMediumWealth },
+		DeveloperTypeName{ "cs3", DeveloperType::CommercialServicesHighWealth },
+		DeveloperTypeName{ "co2", DeveloperType::CommercialOfficeMediumWealth },
+		DeveloperTypeName{ "co3", DeveloperType::CommercialOfficeHighWealth },
+		DeveloperTypeName{ "ir", DeveloperType::IndustrialAgriculture },
+		DeveloperTypeName{ "id", DeveloperType::IndustrialProcessing },
+		DeveloperTypeName{ "im", DeveloperType::IndustrialManufacturing },
+		DeveloperTypeName{ "iht", DeveloperType::IndustrialHighTech },
+	};
+
+	static constexpr std::array<WealthType, 3> LotStatsWealthTypes =
+	{
+		WealthType::Low,
+		WealthType::Medium,
+		WealthType::High,
+	};
+
+	void PushFieldName(cISCLua* lua, const char* name)
+	{
+		lua->PushLString(name, static_cast<uint32_t>(std::char_traits<char>::length(name)));
+	}
+
+	int32_t get_lot_stats(lua_State* pState)
+	{
+		cRZAutoRefCount<cISCLua> lua = SCLuaUtil::GetISCLuaFromFunctionState(pState);
+
+		const BuildingOccupantSnapshot* pSnapshot = spOccupantSnapshot;
+
+		if (pSnapshot && pSnapshot->GetLot())
+		{
+			// All of the values are read from the dialog snapshot, which queries
+			// the lot once when the dialog is opened.
+
+			lua->NewTable();
+
+			PushFieldName(lua, "population");
+			lua->NewTable();
+			for (const DeveloperTypeName& item : LotStatsDeveloperTypes)
+			{
+				PushFieldName(lua, item.name);
+				LuaHelper::PushValue(lua, pSnapshot->GetPopulation(item.type));
+				lua->RawSet(-3);
+			}
+			lua->RawSet(-3);
+
+			PushFieldName(lua, "capacity");
+			lua->NewTable();
+			for (const DeveloperTypeName& item : LotStatsDeveloperTypes)
+			{
+				PushFieldName(lua, item.name);
+				LuaHelper::PushValue(lua, pSnapshot->GetCapacity(item.type));
+				lua->RawSet(-3);
+			}
+			lua->RawSet(-3);
+
+			// The jobs and travel_jobs arrays are in low, medium, high wealth order.
+
+			PushFieldName(lua, "jobs");
+			lua->NewTable();
+			for (size_t i = 0; i < LotStatsWealthTypes.size(); i++)
+			{
+				LuaHelper::PushValue(lua, pSnapshot->GetJobs(LotStatsWealthTypes[i]));
+				// Lua uses a one-based index for arrays.
+				lua->RawSetI(-2, static_cast<int32_t>(i + 1));
+			}
+			lua->RawSet(-3);
+
+			PushFieldName(lua, "travel_jobs");
+			lua->NewTable();
+			for (size_t i = 0; i < LotStatsWealthTypes.size(); i++)
+			{
+				LuaHelper::PushValue(lua, pSnapshot->GetTravelJobs(LotStatsWealthTypes[i]));
+				lua->RawSetI(-2, static_cast<int32_t>(i + 1));
+			}
+			lua->RawSet(-3);
+
+			PushFieldName(lua, "plopped");
+			LuaHelper::PushValue(lua, pSnapshot->IsPlopped());
+			lua->RawSet(-3);
+
+			uint8_t growthStage = 0;
+
+			if (pSnapshot->GetGrowthStage(growthStage))
+			{
+				PushFieldName(lua, "growth_stage");
+				LuaHelper::PushValue(lua, growthStage);
+				lua->RawSet(-3);
+			}
+		}
+		else
+		{
+			lua->PushNil();
+		}
+
+		return 1;
+	}
+
+	typedef int32_t (*LuaFunction)(lua_State* pState);
+
+	struct LuaFunctionEntry
+	{
+		const char* name;
+		LuaFunction function;
+	};
+
+	static constexpr std::array<LuaFunctionEntry, 6> LuaFunctions =
+	{
+		LuaFunctionEntry{ "get_property_value", &get_property_value },
+		LuaFunctionEntry{ "get_property_value_by_name", &get_property_value_by_name },
+		LuaFunctionEntry{ "get_property_values", &get_property_values },
+		LuaFunctionEntry{ "get_property_array_view", &get_property_array_view },
+		LuaFunctionEntry{ "occupant", &occupant },
+		LuaFunctionEntry{ "get_lot_stats", &get_lot_stats },
+	};
 }
 
-QueryUILuaExtensions::QueryUILuaExtensions()
+QueryUILuaExtensions::QueryUILuaExtensions(const ISettings& settings)
+	: settings(settings)
 {
 }
 
@@ -84,42 +641,48 @@ void QueryUILuaExtensions::PostCityInit(cISC4AdvisorSystem* pAdvisorSystem)
 {
 	Logger& logger = Logger::GetInstance();
 
-	const auto status = SCLuaUtil::RegisterLuaFunction(
-		pAdvisorSystem,
-		"null45_query_ui_extensions",
-		"get_property_value",
-		&get_property_value);
-
-	if (status == SCLuaUtil::RegisterLuaFunctionStatus::Ok)
+	for (const LuaFunctionEntry& entry : LuaFunctions)
 	{
-		logger.WriteLine(
-			LogLevel::Info,
-			"Registered the null45_query_ui_extensions.get_property_value function.");
-	}
-	else
-	{
-		logger.WriteLine(
-			LogLevel::Info,
-			"Failed to register the null45_query_ui_extensions.get_property_value function. "
-			"Is SC4QueryUIHooks.dat in the plugins folder?");
+		const auto status = SCLuaUtil::RegisterLuaFunction(
+			pAdvisorSystem,
+			"null45_query_ui_extensions",
+			entry.name,
+			entry.function);
+
+		if (status == SCLuaUtil::RegisterLuaFunctionStatus::Ok)
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Info,
+				"Registered the null45_query_ui_extensions.%s function.",
+				entry.name);
+		}
+		else
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Info,
+				"Failed to register the null45_query_ui_extensions.%s function. "
+				"Is SC4QueryUIHooks.dat in the plugins folder?",
+				entry.name);
+		}
 	}
 }
 
 void QueryUILuaExtensions::PreCityShutdown()
 {
-	spOccupant = nullptr;
+	ClearOccupantSnapshots();
 }
 
-void QueryUILuaExtensions::BeforeDialogShown(cISC4Occupant* pOccupant)
+void QueryUILuaExtensions::BeforeDialogShown(const BuildingOccupantSnapshot* pSnapshot)
 {
-	spOccupant = pOccupant;
+	PushOccupantSnapshot(pSnapshot);
 
 #ifdef _DEBUG
-	QueryUILuaExtensionsTest::Run();
+	QueryUILuaExtensionsTest::Run(settings.RecordLuaTestFixture());
 #endif // _DEBUG
 }
 
-void QueryUILuaExtensions::AfterDialogShown(cISC4Occupant* pOccupant)
+void QueryUILuaExtensions::AfterDialogShown()
 {
-	spOccupant = nullptr;
+	// Restore the snapshot and generation of the outer dialog, if any.
+	PopOccupantSnapshot();
 }
\ No newline at end of file
@@ -20,19 +20,27 @@
  */
 
 #pragma once
+#include "ISettings.h"
 
+class BuildingOccupantSnapshot;
 class cISC4AdvisorSystem;
-class cISC4Occupant;
 
 class QueryUILuaExtensions
 {
 public:
-	QueryUILuaExtensions();
+	QueryUILuaExtensions(const ISettings& settings);
 
 	void PostCityInit(cISC4AdvisorSystem* pAdvisorSystem);
 	void PreCityShutdown();
 
-	void BeforeDialogShown(cISC4Occupant* pOccupant);
-	void AfterDialogShown(cISC4Occupant* pOccupant);
+	void BeforeDialogShown(const BuildingOccupantSnapshot* pSnapshot);
+	/**
+	 * @brief Called after the query dialog has been closed, the snapshot of the dialog that
+	 * was being shown when the closed dialog was opened becomes the current snapshot.
+	 */
+	void AfterDialogShown();
+
+private:
+	const ISettings& settings;
 };
 
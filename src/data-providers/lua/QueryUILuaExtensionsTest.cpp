@@ -25,14 +25,46 @@
 #include "cISC4City.h"
 #include "cISCLua.h"
 #include "DebugUtil.h"
+#include "FileSystem.h"
 #include "GZServPtrs.h"
 
-#include <array>
+#include <chrono>
+#include <fstream>
+#include <string>
 
 namespace
 {
-	void RunTestFunction(cIGZLua5Thread* pIGZLua5Thread, const char* functionName)
+	// The global table that lists the test functions, each entry is a table with the
+	// following fields:
+	// name: the name of the global test function, the function takes no parameters and returns a string.
+	// expected: optional, the string that the function must return.
+	// iterations: optional, the number of times the function is called when measuring its latency.
+	// Other Lua scripts can add entries to the table to have their own query functions tested.
+	static constexpr const char* TestFunctionTableName = "null45_query_ui_extensions_test_functions";
+
+	// The global function that returns the test fixture of the current occupant, the fixture
+	// is a Lua script that the headless test runner in src/tests uses to run the test
+	// functions without the game.
+	static constexpr const char* RecordFixtureFunctionName = "null45_query_ui_extensions_test_record_fixture";
+
+	// Limits the total time of the latency measurement for functions that are slow.
+	static constexpr uint32_t MaxIterations = 10000;
+
+	struct TestSummary
+	{
+		uint32_t passed;
+		uint32_t failed;
+		uint32_t unchecked;
+
+		TestSummary() : passed(0), failed(0), unchecked(0)
+		{
+		}
+	};
+
+	bool CallTestFunction(cIGZLua5Thread* pIGZLua5Thread, const char* functionName, std::string& result)
 	{
+		bool succeeded = false;
+
 		int32_t top = pIGZLua5Thread->GetTop();
 
 		pIGZLua5Thread->GetGlobal(functionName);
@@ -51,12 +83,10 @@ namespace
 				{
 					if (pIGZLua5Thread->IsString(-1))
 					{
-						const char* result = pIGZLua5Thread->ToString(-1);
+						const char* value = pIGZLua5Thread->ToString(-1);
 
-						DebugUtil::PrintLineToDebugOutputFormatted(
-							"%s() returned: %s",
-							functionName,
-							result ? result : "<null>");
+						result = value ? value : "<null>";
+						succeeded = true;
 					}
 					else
 					{
@@ -95,25 +125,187 @@ namespace
 		}
 
 		pIGZLua5Thread->SetTop(top);
+
+		return succeeded;
+	}
+
+	void RunTestFunction(
+		cIGZLua5Thread* pIGZLua5Thread,
+		const char* functionName,
+		const char* expected,
+		uint32_t iterations,
+		TestSummary& summary)
+	{
+		std::string result;
+
+		if (!CallTestFunction(pIGZLua5Thread, functionName, result))
+		{
+			summary.failed++;
+			return;
+		}
+
+		if (expected)
+		{
+			if (result == expected)
+			{
+				summary.passed++;
+				DebugUtil::PrintLineToDebugOutputFormatted("PASS %s() returned: %s", functionName, result.c_str());
+			}
+			else
+			{
+				summary.failed++;
+				DebugUtil::PrintLineToDebugOutputFormatted(
+					"FAIL %s() returned: %s, expected: %s",
+					functionName,
+					result.c_str(),
+					expected);
+			}
+		}
+		else
+		{
+			summary.unchecked++;
+			DebugUtil::PrintLineToDebugOutputFormatted("%s() returned: %s", functionName, result.c_str());
+		}
+
+		// The first call is excluded from the latency measurement, it may include
+		// one-time costs such as building the per-dialog caches.
+
+		const auto start = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			CallTestFunction(pIGZLua5Thread, functionName, result);
+		}
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start);
+
+		DebugUtil::PrintLineToDebugOutputFormatted(
+			"%s() latency: %.3f us per call (%u calls).",
+			functionName,
+			static_cast<double>(elapsed.count()) / 1000.0 / static_cast<double>(iterations),
+			iterations);
+	}
+
+	const char* GetStringField(cIGZLua5Thread* pIGZLua5Thread, const char* name)
+	{
+		// The entry table is at the top of the stack.
+		// The returned string is owned by the entry table, so it remains valid while
+		// the table is on the stack.
+		const char* value = nullptr;
+
+		pIGZLua5Thread->PushLString(name, static_cast<uint32_t>(std::char_traits<char>::length(name)));
+		pIGZLua5Thread->RawGet(-2);
+
+		if (pIGZLua5Thread->IsString(-1))
+		{
+			value = pIGZLua5Thread->ToString(-1);
+		}
+
+		pIGZLua5Thread->Pop(1);
+
+		return value;
+	}
+
+	uint32_t GetIterationsField(cIGZLua5Thread* pIGZLua5Thread)
+	{
+		uint32_t iterations = 1;
+
+		pIGZLua5Thread->PushLString("iterations", 10);
+		pIGZLua5Thread->RawGet(-2);
+
+		if (pIGZLua5Thread->IsNumber(-1))
+		{
+			const double value = pIGZLua5Thread->ToNumber(-1);
+
+			if (value >= 1.0)
+			{
+				iterations = value < static_cast<double>(MaxIterations) ? static_cast<uint32_t>(value) : MaxIterations;
+			}
+		}
+
+		pIGZLua5Thread->Pop(1);
+
+		return iterations;
 	}
 
 	void RunLuaScriptTests(cIGZLua5Thread* pIGZLua5Thread)
 	{
-		constexpr std::array<const char*, 3> QueryUIExtensionsLuaTestFunctions =
+		const int32_t top = pIGZLua5Thread->GetTop();
+
+		pIGZLua5Thread->GetGlobal(TestFunctionTableName);
+
+		if (pIGZLua5Thread->IsTable(-1))
+		{
+			TestSummary summary;
+
+			// Lua uses a one-based index for arrays.
+			for (int32_t i = 1; ; i++)
+			{
+				pIGZLua5Thread->RawGetI(-1, i);
+
+				if (!pIGZLua5Thread->IsTable(-1))
+				{
+					break;
+				}
+
+				const char* name = GetStringField(pIGZLua5Thread, "name");
+
+				if (name)
+				{
+					RunTestFunction(
+						pIGZLua5Thread,
+						name,
+						GetStringField(pIGZLua5Thread, "expected"),
+						GetIterationsField(pIGZLua5Thread),
+						summary);
+				}
+
+				pIGZLua5Thread->Pop(1);
+			}
+
+			DebugUtil::PrintLineToDebugOutputFormatted(
+				"Lua query UI tests: %u passed, %u failed, %u without an expected value.",
+				summary.passed,
+				summary.failed,
+				summary.unchecked);
+		}
+		else
 		{
-			"null45_query_ui_extensions_test_get_exemplar_name",
-			"null45_query_ui_extensions_test_get_bulldoze_cost",
-			"null45_query_ui_extensions_test_get_garbage_pollution_at_center",
-		};
+			DebugUtil::PrintLineToDebugOutputFormatted("%s does not exist.", TestFunctionTableName);
+		}
+
+		pIGZLua5Thread->SetTop(top);
+	}
+
+	void RecordTestFixture(cIGZLua5Thread* pIGZLua5Thread)
+	{
+		std::string fixture;
 
-		for (const auto& item : QueryUIExtensionsLuaTestFunctions)
+		if (CallTestFunction(pIGZLua5Thread, RecordFixtureFunctionName, fixture))
 		{
-			RunTestFunction(pIGZLua5Thread, item);
+			const std::filesystem::path path = FileSystem::GetLuaTestFixtureFilePath();
+
+			std::ofstream stream(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+			if (stream)
+			{
+				stream.write(fixture.data(), static_cast<std::streamsize>(fixture.size()));
+			}
+
+			if (stream)
+			{
+				DebugUtil::PrintLineToDebugOutputFormatted("Recorded the Lua test fixture: %s", path.string().c_str());
+			}
+			else
+			{
+				DebugUtil::PrintLineToDebugOutputFormatted("Failed to write the Lua test fixture: %s", path.string().c_str());
+			}
 		}
 	}
 }
 
-void QueryUILuaExtensionsTest::Run()
+void QueryUILuaExtensionsTest::Run(bool recordFixture)
 {
 #ifdef _DEBUG
 	cISC4AppPtr pSC4App;
@@ -132,7 +324,14 @@ void QueryUILuaExtensionsTest::Run()
 
 				if (pLua)
 				{
-					RunLuaScriptTests(pLua->AsIGZLua5()->AsIGZLua5Thread());
+					cIGZLua5Thread* pIGZLua5Thread = pLua->AsIGZLua5()->AsIGZLua5Thread();
+
+					RunLuaScriptTests(pIGZLua5Thread);
+
+					if (recordFixture)
+					{
+						RecordTestFixture(pIGZLua5Thread);
+					}
 				}
 			}
 		}
@@ -23,5 +23,12 @@
 
 namespace QueryUILuaExtensionsTest
 {
-	void Run();
+	/**
+	 * @brief Runs the Lua functions listed in the null45_query_ui_extensions_test_functions
+	 * table against the current query dialog occupant, checks their results and reports
+	 * their latency to the debug output. Only available in debug builds.
+	 * @param recordFixture true to write the test fixture of the current occupant to
+	 * SC4QueryUIHooks.LuaTestFixture.lua; otherwise, false.
+	 */
+	void Run(bool recordFixture);
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+// The priority that is used for the subscribers that are added without specifying one.
+// Subscribers with a higher priority are notified first, subscribers with the same
+// priority are notified in the order that they were added.
+static const int32_t QueryHookDefaultPriority = 0;
\ No newline at end of file
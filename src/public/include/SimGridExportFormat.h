@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+// The file format that is written by the ExportSimGrids cheat.
+//
+// The file starts with a SimGridExportHeader, followed by a table of columnCount
+// SimGridExportColumn entries. The data of each column starts at a multiple of
+// pageSize from the start of the file, so the file can be memory mapped and the
+// columns used in place without parsing.
+//
+// Each column stores one value per city cell in row-major order: the value of
+// cell (x, z) is at index z * cellCountX + x.
+// All values are little-endian.
+//
+// The ExportSimGrids cheat writes the following columns, a column is omitted if the
+// game simulator that provides it is not available:
+//
+// flammability (UInt8): the flammability simulator grid value.
+// intrinsic_land_value (UInt8): the land value simulator intrinsic land value map value.
+// land_value (UInt8): the land value.
+// land_value_type (UInt8): the land value wealth level, a SimGridExportLandValueType value.
+// mayor_rating (Int8): the mayor rating simulator grid value.
+// air_pollution, water_pollution, garbage_pollution (Int32): the pollution values.
+// radioactive (UInt8): 1 if the cell is radioactive; otherwise, 0.
+// moisture (UInt8): the weather simulator moisture value at the cell center.
+// humidity (Float32): the weather simulator humidity at the cell center.
+
+static const char SimGridExportMagic[8] = { 'S', 'C', '4', 'G', 'R', 'I', 'D', '\0' };
+static const uint32_t SimGridExportVersion = 1;
+static const uint32_t SimGridExportPageSize = 4096;
+static const uint32_t SimGridExportColumnNameLength = 32;
+
+enum class SimGridExportValueType : uint32_t
+{
+	UInt8 = 0,
+	Int8 = 1,
+	Int32 = 2,
+	Float32 = 3,
+};
+
+// The values of the land_value_type column. The game's land value type is converted to
+// these values, so they do not depend on the game's internal numbering.
+enum class SimGridExportLandValueType : uint8_t
+{
+	// The cell does not have a low, medium or high land value type.
+	Unknown = 0,
+	Low = 1,
+	Medium = 2,
+	High = 3,
+};
+
+struct SimGridExportHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+	uint32_t pageSize;
+	uint32_t cellCountX;
+	uint32_t cellCountZ;
+	uint32_t columnCount;
+	uint64_t columnTableOffset;
+	uint64_t fileSize;
+};
+
+struct SimGridExportColumn
+{
+	// The column name, padded with null characters.
+	char name[SimGridExportColumnNameLength];
+	SimGridExportValueType valueType;
+	uint32_t valueSize;
+	uint64_t offset;
+	uint64_t size;
+};
+
+static_assert(sizeof(SimGridExportHeader) == 48, "The SimGridExportHeader layout must not change.");
+static_assert(sizeof(SimGridExportColumn) == 56, "The SimGridExportColumn layout must not change.");
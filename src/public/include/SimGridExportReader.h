@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "SimGridExportFormat.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SIM_GRID_EXPORT_READER_HAS_MMAP 1
+#endif
+
+// A header-only reader for the files written by the ExportSimGrids cheat, for use in
+// external analysis tools.
+// The reader validates the header and column table once, the column data is then
+// accessed in place.
+class SimGridExportReader
+{
+public:
+	SimGridExportReader()
+		: data(nullptr), size(0), mappedData(nullptr), mappedSize(0)
+	{
+	}
+
+	~SimGridExportReader()
+	{
+		Close();
+	}
+
+	SimGridExportReader(const SimGridExportReader&) = delete;
+	SimGridExportReader& operator=(const SimGridExportReader&) = delete;
+
+	/**
+	 * @brief Uses a file that was already loaded or mapped into memory.
+	 * The memory must stay valid while the reader is in use.
+	 * @param buffer The file data, it must be aligned to at least 4 bytes.
+	 * @param bufferSize The file size.
+	 * @return true if the file is valid; otherwise, false.
+	 */
+	bool Attach(const void* buffer, size_t bufferSize)
+	{
+		Close();
+
+		if (!Validate(static_cast<const uint8_t*>(buffer), bufferSize))
+		{
+			return false;
+		}
+
+		data = static_cast<const uint8_t*>(buffer);
+		size = bufferSize;
+		return true;
+	}
+
+#ifdef SIM_GRID_EXPORT_READER_HAS_MMAP
+	/**
+	 * @brief Memory maps the specified file.
+	 * @param path The file path.
+	 * @return true if the file was mapped and is valid; otherwise, false.
+	 */
+	bool Open(const char* path)
+	{
+		Close();
+
+		const int fd = open(path, O_RDONLY);
+
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat fileInfo {};
+		void* mapping = MAP_FAILED;
+
+		if (fstat(fd, &fileInfo) == 0 && fileInfo.st_size > 0)
+		{
+			mapping = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+
+		close(fd);
+
+		if (mapping == MAP_FAILED)
+		{
+			return false;
+		}
+
+		if (!Attach(mapping, static_cast<size_t>(fileInfo.st_size)))
+		{
+			munmap(mapping, static_cast<size_t>(fileInfo.st_size));
+			return false;
+		}
+
+		mappedData = mapping;
+		mappedSize = static_cast<size_t>(fileInfo.st_size);
+		return true;
+	}
+#endif // SIM_GRID_EXPORT_READER_HAS_MMAP
+
+	void Close()
+	{
+#ifdef SIM_GRID_EXPORT_READER_HAS_MMAP
+		if (mappedData)
+		{
+			munmap(mappedData, mappedSize);
+		}
+#endif // SIM_GRID_EXPORT_READER_HAS_MMAP
+
+		data = nullptr;
+		size = 0;
+		mappedData = nullptr;
+		mappedSize = 0;
+	}
+
+	const SimGridExportHeader& GetHeader() const
+	{
+		return *reinterpret_cast<const SimGridExportHeader*>(data);
+	}
+
+	uint32_t GetColumnCount() const
+	{
+		return GetHeader().columnCount;
+	}
+
+	const SimGridExportColumn& GetColumn(uint32_t index) const
+	{
+		return GetColumnTable()[index];
+	}
+
+	/**
+	 * @brief Finds a column by name.
+	 * @param name The column name.
+	 * @return The column, or nullptr if the file does not have a column with that name.
+	 */
+	const SimGridExportColumn* FindColumn(std::string_view name) const
+	{
+		const SimGridExportColumn* const columns = GetColumnTable();
+		const uint32_t columnCount = GetColumnCount();
+
+		for (uint32_t i = 0; i < columnCount; i++)
+		{
+			const SimGridExportColumn& column = columns[i];
+
+			if (std::string_view(column.name, strnlen(column.name, SimGridExportColumnNameLength)) == name)
+			{
+				return &column;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * @brief Gets the values of a column.
+	 * @tparam T The value type, its size must match the column value size.
+	 * @param column The column.
+	 * @return The column values, or nullptr if the value size does not match.
+	 */
+	template <typename T> const T* GetColumnValues(const SimGridExportColumn& column) const
+	{
+		if (sizeof(T) != column.valueSize)
+		{
+			return nullptr;
+		}
+
+		return reinterpret_cast<const T*>(data + column.offset);
+	}
+
+private:
+	const SimGridExportColumn* GetColumnTable() const
+	{
+		return reinterpret_cast<const SimGridExportColumn*>(data + GetHeader().columnTableOffset);
+	}
+
+	static uint32_t GetValueSize(SimGridExportValueType type)
+	{
+		switch (type)
+		{
+		case SimGridExportValueType::UInt8:
+		case SimGridExportValueType::Int8:
+			return 1;
+		case SimGridExportValueType::Int32:
+		case SimGridExportValueType::Float32:
+			return 4;
+		default:
+			return 0;
+		}
+	}
+
+	static bool Validate(const uint8_t* buffer, size_t bufferSize)
+	{
+		if (!buffer || bufferSize < sizeof(SimGridExportHeader))
+		{
+			return false;
+		}
+
+		const SimGridExportHeader* header = reinterpret_cast<const SimGridExportHeader*>(buffer);
+
+		if (std::memcmp(header->magic, SimGridExportMagic, sizeof(SimGridExportMagic)) != 0
+			|| header->version != SimGridExportVersion
+			|| header->headerSize != sizeof(SimGridExportHeader)
+			|| header->pageSize == 0
+			|| header->fileSize != bufferSize
+			|| header->columnTableOffset % alignof(SimGridExportColumn) != 0
+			|| header->columnTableOffset > bufferSize
+			|| header->columnCount > (bufferSize - header->columnTableOffset) / sizeof(SimGridExportColumn))
+		{
+			return false;
+		}
+
+		const uint64_t cellCount = static_cast<uint64_t>(header->cellCountX) * header->cellCountZ;
+		const SimGridExportColumn* columns = reinterpret_cast<const SimGridExportColumn*>(buffer + header->columnTableOffset);
+
+		for (uint32_t i = 0; i < header->columnCount; i++)
+		{
+			const SimGridExportColumn& column = columns[i];
+			const uint32_t valueSize = GetValueSize(column.valueType);
+
+			if (valueSize == 0
+				|| column.valueSize != valueSize
+				|| column.offset % header->pageSize != 0
+				|| column.size != cellCount * valueSize
+				|| column.offset > bufferSize
+				|| column.size > bufferSize - column.offset)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	const uint8_t* data;
+	size_t size;
+	void* mappedData;
+	size_t mappedSize;
+};
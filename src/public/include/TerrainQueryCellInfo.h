@@ -0,0 +1,66 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <cstdint>
+
+enum TerrainQueryModifierKeys : uint32_t
+{
+	TerrainQueryModifierKeyNone = 0,
+	TerrainQueryModifierKeyControl = 1 << 0,
+	TerrainQueryModifierKeyAlt = 1 << 1,
+	TerrainQueryModifierKeyShift = 1 << 2,
+};
+
+enum class TerrainQueryLandValueType : uint32_t
+{
+	Unknown = 0,
+	Low,
+	Medium,
+	High,
+};
+
+// The terrain position and simulation data of the cell that is being queried.
+// The cell data is read once per tool tip and shared by all subscribers.
+// New fields will only be added at the end of the structure, a subscriber must check
+// that size covers a field before it reads that field.
+struct TerrainQueryCellInfo
+{
+	// The size of the structure in bytes, set by the hook server.
+	uint32_t size;
+	// The world position under the cursor.
+	float x;
+	float y;
+	float z;
+	// The cell under the cursor.
+	int32_t cellX;
+	int32_t cellZ;
+	// The TerrainQueryModifierKeys that were held down.
+	uint32_t modifierKeys;
+	// true if the simulation data fields below are valid; otherwise, false.
+	// The simulation data is not available when a city is not loaded.
+	bool hasSimulationData;
+	uint8_t moisture;
+	uint8_t flammability;
+	uint8_t intrinsicLandValue;
+	uint8_t totalLandValue;
+	TerrainQueryLandValueType landValueType;
+	int8_t mayorRating;
+	bool radioactive;
+	int32_t airPollution;
+	int32_t waterPollution;
+	int32_t garbagePollution;
+	float humidity;
+	float ambientWindSpeed;
+	float ambientWindDirectionX;
+	float ambientWindDirectionY;
+};
@@ -0,0 +1,31 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIBuildingQueryHookServer.h"
+#include "QueryHookPriority.h"
+
+static const uint32_t GZIID_cIBuildingQueryHookServer2 = 0xE2D3C98A;
+
+// Extends cIBuildingQueryHookServer with subscriber priorities.
+// The server class id is the same as cIBuildingQueryHookServer, use this interface id to get it.
+class cIBuildingQueryHookServer2 : public cIBuildingQueryHookServer
+{
+public:
+	using cIBuildingQueryHookServer::AddNotification;
+
+	virtual bool AddNotification(cIBuildingQueryDialogHookTarget* target, int32_t priority) = 0;
+
+	virtual bool AddNotification(cIBuildingQueryCustomToolTipHookTarget* target, int32_t priority) = 0;
+
+	virtual bool AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority) = 0;
+};
\ No newline at end of file
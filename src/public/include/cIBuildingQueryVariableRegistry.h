@@ -0,0 +1,54 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include "cIGZUnknown.h"
+
+class cIBuildingQueryVariableTarget;
+
+static const uint32_t GZCLSID_cIBuildingQueryVariableRegistry = 0x1F8AFD42;
+static const uint32_t GZIID_cIBuildingQueryVariableRegistry = 0x4D82146C;
+
+/**
+ * @brief Allows other DLLs to provide building query dialog variables without
+ * registering their own cISCStringDetokenizer unknown token callback.
+ *
+ * A named variable is used as #name# in the LTEXT files.
+ * A parameterized variable is used as #prefix:parameters#, the parameter text
+ * is everything after the first colon.
+ *
+ * The variables provided by this DLL take precedence over the registered variables.
+ */
+class cIBuildingQueryVariableRegistry : public cIGZUnknown
+{
+public:
+	/**
+	 * @brief Registers a named variable.
+	 * @param name The variable name, without the surrounding # characters. Cannot contain a colon.
+	 * @param target The callback target that provides the variable value.
+	 * @return true if the variable was registered; otherwise, false if the name is invalid
+	 * or it is already registered.
+	 */
+	virtual bool RegisterVariable(const char* name, cIBuildingQueryVariableTarget* target) = 0;
+	virtual bool UnregisterVariable(const char* name, cIBuildingQueryVariableTarget* target) = 0;
+
+	/**
+	 * @brief Registers a parameterized variable.
+	 * @param prefix The variable prefix, without the trailing colon. Cannot contain a colon.
+	 * @param target The callback target that provides the variable value.
+	 * @return true if the variable was registered; otherwise, false if the prefix is invalid
+	 * or it is already registered.
+	 */
+	virtual bool RegisterParameterizedVariable(const char* prefix, cIBuildingQueryVariableTarget* target) = 0;
+	virtual bool UnregisterParameterizedVariable(const char* prefix, cIBuildingQueryVariableTarget* target) = 0;
+};
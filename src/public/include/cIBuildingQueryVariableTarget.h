@@ -0,0 +1,39 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include "cIGZUnknown.h"
+
+class cIGZString;
+class cISC4Occupant;
+
+static const uint32_t GZIID_cIBuildingQueryVariableTarget = 0xD18F5EB5;
+
+class cIBuildingQueryVariableTarget : public cIGZUnknown
+{
+public:
+	/**
+	 * @brief Gets the value of a building query dialog variable.
+	 * @param occupant The occupant that is being queried.
+	 * @param name The variable name, or the prefix for a parameterized variable.
+	 * @param parameters The text after the first colon for a parameterized variable;
+	 * otherwise, an empty string.
+	 * @param destination The string that receives the variable value.
+	 * @return true if the variable value was set; otherwise, false to show an empty string.
+	 */
+	virtual bool GetVariableValue(
+		cISC4Occupant* occupant,
+		const cIGZString& name,
+		const cIGZString& parameters,
+		cIGZString& destination) = 0;
+};
@@ -0,0 +1,29 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIFloraQueryToolTipHookServer.h"
+#include "QueryHookPriority.h"
+
+static const uint32_t GZIID_cIFloraQueryToolTipHookServer2 = 0xE855F1A6;
+
+// Extends cIFloraQueryToolTipHookServer with subscriber priorities.
+// The server class id is the same as cIFloraQueryToolTipHookServer, use this interface id to get it.
+class cIFloraQueryToolTipHookServer2 : public cIFloraQueryToolTipHookServer
+{
+public:
+	using cIFloraQueryToolTipHookServer::AddNotification;
+
+	virtual bool AddNotification(cIFloraQueryCustomToolTipHookTarget* target, int32_t priority) = 0;
+
+	virtual bool AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority) = 0;
+};
\ No newline at end of file
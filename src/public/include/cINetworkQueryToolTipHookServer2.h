@@ -0,0 +1,29 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cINetworkQueryToolTipHookServer.h"
+#include "QueryHookPriority.h"
+
+static const uint32_t GZIID_cINetworkQueryToolTipHookServer2 = 0xBE7B3472;
+
+// Extends cINetworkQueryToolTipHookServer with subscriber priorities.
+// The server class id is the same as cINetworkQueryToolTipHookServer, use this interface id to get it.
+class cINetworkQueryToolTipHookServer2 : public cINetworkQueryToolTipHookServer
+{
+public:
+	using cINetworkQueryToolTipHookServer::AddNotification;
+
+	virtual bool AddNotification(cINetworkQueryCustomToolTipHookTarget* target, int32_t priority) = 0;
+
+	virtual bool AddNotification(cIQueryToolTipAppendTextHookTarget* target, int32_t priority) = 0;
+};
\ No newline at end of file
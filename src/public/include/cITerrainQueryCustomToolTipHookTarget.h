@@ -0,0 +1,33 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZUnknown.h"
+
+class cIGZString;
+struct TerrainQueryCellInfo;
+
+static const uint32_t GZIID_cITerrainQueryCustomToolTipHookTarget = 0x5D214108;
+
+class cITerrainQueryCustomToolTipHookTarget : public cIGZUnknown
+{
+public:
+	/**
+	 * @brief A callback that allows for customized terrain query hover tool tips.
+	 * @param cellInfo The position and simulation data of the cell that is being queried.
+	 * @param text The tool tip message.
+	 * @return true if a custom tool tip was set; otherwise, false to show the default tool tip.
+	 */
+	virtual bool ProcessToolTip(
+		const TerrainQueryCellInfo& cellInfo,
+		cIGZString& text) = 0;
+};
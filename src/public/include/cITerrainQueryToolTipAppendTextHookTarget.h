@@ -0,0 +1,33 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZUnknown.h"
+
+class cIGZString;
+struct TerrainQueryCellInfo;
+
+static const uint32_t GZIID_cITerrainQueryToolTipAppendTextHookTarget = 0xAFA63B2D;
+
+class cITerrainQueryToolTipAppendTextHookTarget : public cIGZUnknown
+{
+public:
+	/**
+	 * @brief A callback that allows text to be appended at the bottom of a terrain query hover tool tip.
+	 * @param cellInfo The position and simulation data of the cell that is being queried.
+	 * @param textToAppend The text that should be appended.
+	 * @return true if text should be appended; otherwise, false.
+	 */
+	virtual bool AppendQueryToolTipText(
+		const TerrainQueryCellInfo& cellInfo,
+		cIGZString& textToAppend) = 0;
+};
@@ -0,0 +1,33 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+// extends the query UI.
+//
+// Copyright (c) 2026 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZUnknown.h"
+#include "QueryHookPriority.h"
+
+class cITerrainQueryCustomToolTipHookTarget;
+class cITerrainQueryToolTipAppendTextHookTarget;
+
+static const uint32_t GZCLSID_cITerrainQueryToolTipHookServer = 0x372544B8;
+static const uint32_t GZIID_cITerrainQueryToolTipHookServer = 0xDC6A1E0C;
+
+class cITerrainQueryToolTipHookServer : public cIGZUnknown
+{
+public:
+	virtual bool AddNotification(cITerrainQueryCustomToolTipHookTarget* target) = 0;
+	virtual bool AddNotification(cITerrainQueryCustomToolTipHookTarget* target, int32_t priority) = 0;
+	virtual bool RemoveNotification(cITerrainQueryCustomToolTipHookTarget* target) = 0;
+
+	virtual bool AddNotification(cITerrainQueryToolTipAppendTextHookTarget* target) = 0;
+	virtual bool AddNotification(cITerrainQueryToolTipAppendTextHookTarget* target, int32_t priority) = 0;
+	virtual bool RemoveNotification(cITerrainQueryToolTipAppendTextHookTarget* target) = 0;
+};
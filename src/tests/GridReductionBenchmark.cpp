@@ -0,0 +1,104 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridReduction.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	template <typename Func>
+	double MeasureNanosecondsPerIteration(uint32_t iterations, Func&& func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			func();
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+	}
+
+	void BenchmarkGridSize(size_t count, const char* description)
+	{
+		static constexpr uint32_t Iterations = 20000;
+
+		std::mt19937 random(1);
+		std::uniform_int_distribution<int32_t> distribution(0, 255);
+		std::vector<int32_t> values(count);
+
+		for (int32_t& value : values)
+		{
+			value = distribution(random);
+		}
+
+		int32_t minimum = 0;
+		int32_t maximum = 0;
+		int64_t sum = 0;
+		volatile int64_t sink = 0;
+
+		const double simd = MeasureNanosecondsPerIteration(Iterations, [&]()
+		{
+			GridReduction::MinMaxSum(values.data(), values.size(), minimum, maximum, sum);
+			sink = sink + sum + minimum + maximum;
+		});
+
+		const double scalar = MeasureNanosecondsPerIteration(Iterations, [&]()
+		{
+			GridReduction::MinMaxSumScalar(values.data(), values.size(), minimum, maximum, sum);
+			sink = sink + sum + minimum + maximum;
+		});
+
+		std::vector<int32_t> buffer(count);
+
+		const double compute = MeasureNanosecondsPerIteration(Iterations / 10, [&]()
+		{
+			buffer = values;
+			const GridStatistics statistics = GridReduction::Compute(buffer.data(), buffer.size());
+			sink = sink + statistics.median;
+		});
+
+		std::printf(
+			"%s (%zu values): MinMaxSum %.0f ns, MinMaxSumScalar %.0f ns, Compute %.0f ns\n",
+			description,
+			count,
+			simd,
+			scalar,
+			compute);
+	}
+}
+
+int main()
+{
+	// A radius 8 aggregate query covers about 200 cells, a radius 32 query about 3,200 cells.
+	BenchmarkGridSize(201, "Radius 8");
+	BenchmarkGridSize(3205, "Radius 32");
+	BenchmarkGridSize(64 * 64, "64x64 grid");
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridReduction.h"
+#include "TestUtil.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	void CheckKernelsMatch(const std::vector<int32_t>& values)
+	{
+		int32_t minimum = 0;
+		int32_t maximum = 0;
+		int64_t sum = 0;
+		int32_t referenceMinimum = 0;
+		int32_t referenceMaximum = 0;
+		int64_t referenceSum = 0;
+
+		GridReduction::MinMaxSum(values.data(), values.size(), minimum, maximum, sum);
+		GridReduction::MinMaxSumScalar(values.data(), values.size(), referenceMinimum, referenceMaximum, referenceSum);
+
+		TEST_CHECK(minimum == referenceMinimum);
+		TEST_CHECK(maximum == referenceMaximum);
+		TEST_CHECK(sum == referenceSum);
+	}
+
+	// The percentiles use the nearest-rank method.
+	int32_t GetSortedPercentile(const std::vector<int32_t>& sortedValues, size_t percentile)
+	{
+		const size_t rank = std::max<size_t>(1, (sortedValues.size() * percentile + 99) / 100);
+
+		return sortedValues[rank - 1];
+	}
+
+	void CheckStatistics(std::vector<int32_t> values)
+	{
+		std::vector<int32_t> sortedValues = values;
+		std::sort(sortedValues.begin(), sortedValues.end());
+
+		int64_t sum = 0;
+
+		for (int32_t value : sortedValues)
+		{
+			sum += value;
+		}
+
+		const GridStatistics statistics = GridReduction::Compute(values.data(), values.size());
+
+		TEST_CHECK(statistics.count == sortedValues.size());
+		TEST_CHECK(statistics.minimum == sortedValues.front());
+		TEST_CHECK(statistics.maximum == sortedValues.back());
+		TEST_CHECK(statistics.mean == static_cast<double>(sum) / static_cast<double>(sortedValues.size()));
+		TEST_CHECK(statistics.median == GetSortedPercentile(sortedValues, 50));
+		TEST_CHECK(statistics.percentile90 == GetSortedPercentile(sortedValues, 90));
+	}
+
+	// Covers every remainder of the 8 value SIMD loop for the grid value range
+	// and for the full int32_t range, which checks the widened 64-bit sum.
+	void TestRandomValues()
+	{
+		std::mt19937 random(1);
+		std::uniform_int_distribution<int32_t> gridValues(0, 255);
+		std::uniform_int_distribution<int32_t> fullRangeValues(
+			std::numeric_limits<int32_t>::min(),
+			std::numeric_limits<int32_t>::max());
+
+		for (size_t count = 1; count < 300; count++)
+		{
+			std::vector<int32_t> values(count);
+
+			for (int32_t& value : values)
+			{
+				value = gridValues(random);
+			}
+
+			CheckKernelsMatch(values);
+			CheckStatistics(values);
+
+			for (int32_t& value : values)
+			{
+				value = fullRangeValues(random);
+			}
+
+			CheckKernelsMatch(values);
+			CheckStatistics(values);
+		}
+	}
+
+	void TestExtremeValues()
+	{
+		// The minimum and maximum are placed in different SIMD lanes and in the scalar tail.
+		for (size_t count = 1; count < 40; count++)
+		{
+			for (size_t position = 0; position < count; position++)
+			{
+				std::vector<int32_t> values(count, 0);
+
+				values[position] = std::numeric_limits<int32_t>::min();
+				CheckKernelsMatch(values);
+
+				values[position] = std::numeric_limits<int32_t>::max();
+				CheckKernelsMatch(values);
+			}
+		}
+
+		std::vector<int32_t> maximumValues(1000, std::numeric_limits<int32_t>::max());
+		CheckKernelsMatch(maximumValues);
+		CheckStatistics(maximumValues);
+
+		std::vector<int32_t> minimumValues(1000, std::numeric_limits<int32_t>::min());
+		CheckKernelsMatch(minimumValues);
+		CheckStatistics(minimumValues);
+	}
+
+	void TestEmpty()
+	{
+		const GridStatistics statistics = GridReduction::Compute(nullptr, 0);
+
+		TEST_CHECK(statistics.count == 0);
+		TEST_CHECK(statistics.minimum == 0);
+		TEST_CHECK(statistics.maximum == 0);
+		TEST_CHECK(statistics.mean == 0.0);
+		TEST_CHECK(statistics.median == 0);
+		TEST_CHECK(statistics.percentile90 == 0);
+	}
+
+	void TestPercentiles()
+	{
+		std::vector<int32_t> values;
+
+		for (int32_t i = 10; i >= 1; i--)
+		{
+			values.push_back(i);
+		}
+
+		const GridStatistics statistics = GridReduction::Compute(values.data(), values.size());
+
+		TEST_CHECK(statistics.median == 5);
+		TEST_CHECK(statistics.percentile90 == 9);
+		TEST_CHECK(statistics.mean == 5.5);
+	}
+}
+
+int main()
+{
+	TestRandomValues();
+	TestExtremeValues();
+	TestEmpty();
+	TestPercentiles();
+
+	return TestUtil::Finish("GridReductionTests");
+}
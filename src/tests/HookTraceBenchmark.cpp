@@ -0,0 +1,126 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HookTrace.h"
+#include "SingleProducerRingBuffer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+namespace
+{
+	template <typename Func>
+	double MeasureNanosecondsPerIteration(uint32_t iterations, Func&& func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			func();
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+	}
+
+	void BenchmarkRingBuffer()
+	{
+		static constexpr uint64_t ItemCount = 1000000;
+		static SingleProducerRingBuffer<uint64_t, 16384> buffer;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		std::thread consumer([]()
+		{
+			uint64_t consumed = 0;
+			uint64_t item = 0;
+
+			while (consumed < ItemCount)
+			{
+				if (buffer.TryPop(item))
+				{
+					consumed++;
+				}
+			}
+		});
+
+		for (uint64_t i = 0; i < ItemCount;)
+		{
+			if (buffer.TryPush(i))
+			{
+				i++;
+			}
+		}
+
+		consumer.join();
+
+		const auto end = std::chrono::steady_clock::now();
+
+		std::printf(
+			"SingleProducerRingBuffer: %.1f ns per item with a concurrent consumer\n",
+			std::chrono::duration<double, std::nano>(end - start).count() / ItemCount);
+	}
+
+	void BenchmarkHookTrace()
+	{
+		static constexpr uint32_t Iterations = 1000000;
+		const int subscriber = 0;
+
+		const double disabled = MeasureNanosecondsPerIteration(Iterations, []()
+		{
+			HookTrace::Scope scope("HookTraceBenchmark");
+		});
+
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / "HookTraceBenchmark.trace.json";
+
+		HookTrace::Start(path);
+
+		const double scope = MeasureNanosecondsPerIteration(Iterations, []()
+		{
+			HookTrace::Scope scope("HookTraceBenchmark");
+		});
+
+		const double subscriberCall = MeasureNanosecondsPerIteration(Iterations, [&subscriber]()
+		{
+			HookTrace::BeginSubscriberCall("HookTraceBenchmark subscriber", "HookTraceBenchmark.dll", &subscriber);
+			HookTrace::End("HookTraceBenchmark subscriber");
+		});
+
+		HookTrace::Stop();
+		std::filesystem::remove(path);
+
+		std::printf("HookTrace disabled: %.1f ns per begin/end pair\n", disabled);
+		std::printf("HookTrace enabled: %.1f ns per begin/end pair\n", scope);
+		std::printf("HookTrace enabled subscriber call: %.1f ns per begin/end pair\n", subscriberCall);
+	}
+}
+
+int main()
+{
+	BenchmarkRingBuffer();
+	BenchmarkHookTrace();
+
+	return 0;
+}
@@ -0,0 +1,280 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HookTrace.h"
+#include "TestUtil.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+	// A minimal JSON syntax checker, it checks that the trace file can be loaded
+	// by a trace viewer without interpreting the values.
+	class JsonValidator
+	{
+	public:
+		explicit JsonValidator(std::string_view text)
+			: text(text), position(0)
+		{
+		}
+
+		bool IsValid()
+		{
+			return ParseValue() && (SkipWhitespace(), position == text.size());
+		}
+
+	private:
+		void SkipWhitespace()
+		{
+			while (position < text.size()
+				&& (text[position] == ' ' || text[position] == '\n' || text[position] == '\r' || text[position] == '\t'))
+			{
+				position++;
+			}
+		}
+
+		bool Match(char c)
+		{
+			SkipWhitespace();
+
+			if (position < text.size() && text[position] == c)
+			{
+				position++;
+				return true;
+			}
+
+			return false;
+		}
+
+		bool ParseValue()
+		{
+			SkipWhitespace();
+
+			if (position == text.size())
+			{
+				return false;
+			}
+
+			switch (text[position])
+			{
+			case '{':
+				return ParseObject();
+			case '[':
+				return ParseArray();
+			case '"':
+				return ParseString();
+			default:
+				return ParseNumber();
+			}
+		}
+
+		bool ParseObject()
+		{
+			Match('{');
+
+			if (Match('}'))
+			{
+				return true;
+			}
+
+			do
+			{
+				SkipWhitespace();
+
+				if (!ParseString() || !Match(':') || !ParseValue())
+				{
+					return false;
+				}
+			} while (Match(','));
+
+			return Match('}');
+		}
+
+		bool ParseArray()
+		{
+			Match('[');
+
+			if (Match(']'))
+			{
+				return true;
+			}
+
+			do
+			{
+				if (!ParseValue())
+				{
+					return false;
+				}
+			} while (Match(','));
+
+			return Match(']');
+		}
+
+		bool ParseString()
+		{
+			if (position == text.size() || text[position] != '"')
+			{
+				return false;
+			}
+
+			position++;
+
+			while (position < text.size() && text[position] != '"')
+			{
+				const unsigned char c = static_cast<unsigned char>(text[position]);
+
+				if (c < 0x20)
+				{
+					return false;
+				}
+
+				position += c == '\\' ? 2 : 1;
+			}
+
+			if (position >= text.size())
+			{
+				return false;
+			}
+
+			position++;
+			return true;
+		}
+
+		bool ParseNumber()
+		{
+			const size_t start = position;
+
+			while (position < text.size()
+				&& (std::string_view("0123456789.-+eE").find(text[position]) != std::string_view::npos))
+			{
+				position++;
+			}
+
+			return position > start;
+		}
+
+		std::string_view text;
+		size_t position;
+	};
+
+	size_t CountOccurrences(std::string_view text, std::string_view value)
+	{
+		size_t count = 0;
+
+		for (size_t i = text.find(value); i != std::string_view::npos; i = text.find(value, i + value.size()))
+		{
+			count++;
+		}
+
+		return count;
+	}
+
+	std::string ReadFile(const std::filesystem::path& path)
+	{
+		std::ifstream stream(path);
+		std::stringstream contents;
+		contents << stream.rdbuf();
+
+		return contents.str();
+	}
+
+	void TestTraceFile()
+	{
+		const std::filesystem::path path = std::filesystem::current_path() / "HookTraceTests.trace.json";
+
+		TEST_CHECK(HookTrace::Start(path));
+		// Only one trace can be active.
+		TEST_CHECK(!HookTrace::Start(path));
+
+		// The module name contains characters that must be escaped in JSON.
+		static constexpr const char* ModuleName = "Test \"Plugin\"\\1.dll";
+		const int subscriber = 0;
+
+		for (int i = 0; i < 100; i++)
+		{
+			HookTrace::Scope outer("HookedTerrainQuerySprintf");
+
+			HookTrace::BeginSubscriberCall("TerrainQueryToolTipHookServer append tool tip hook", ModuleName, &subscriber);
+			HookTrace::End("TerrainQueryToolTipHookServer append tool tip hook");
+		}
+
+		// Events from other threads are discarded.
+		std::thread otherThread([]()
+		{
+			HookTrace::Scope scope("OtherThreadEvent");
+		});
+		otherThread.join();
+
+		HookTrace::Stop();
+
+		const std::string contents = ReadFile(path);
+
+		TEST_CHECK(JsonValidator(contents).IsValid());
+		TEST_CHECK(contents.starts_with("{\"traceEvents\":["));
+		TEST_CHECK(CountOccurrences(contents, "\"ph\":\"B\"") == 200);
+		TEST_CHECK(CountOccurrences(contents, "\"ph\":\"E\"") == 200);
+		TEST_CHECK(CountOccurrences(contents, "\"name\":\"HookedTerrainQuerySprintf\"") == 200);
+		TEST_CHECK(CountOccurrences(contents, "\"module\":\"Test \\\"Plugin\\\"\\\\1.dll\"") == 100);
+		TEST_CHECK(CountOccurrences(contents, "\"subscriber\":\"0x") == 100);
+		TEST_CHECK(CountOccurrences(contents, "OtherThreadEvent") == 0);
+		TEST_CHECK(contents.find("\"droppedEvents\":0}") != std::string::npos);
+
+		std::filesystem::remove(path);
+	}
+
+	void TestRestart()
+	{
+		const std::filesystem::path path = std::filesystem::current_path() / "HookTraceTests.restart.trace.json";
+
+		// A stopped trace can be started again, events recorded while no
+		// trace is active are discarded.
+		HookTrace::Begin("Discarded");
+		HookTrace::End("Discarded");
+
+		TEST_CHECK(HookTrace::Start(path));
+		{
+			HookTrace::Scope scope("Recorded");
+		}
+		HookTrace::Stop();
+
+		const std::string contents = ReadFile(path);
+
+		TEST_CHECK(JsonValidator(contents).IsValid());
+		TEST_CHECK(CountOccurrences(contents, "Recorded") == 2);
+		TEST_CHECK(CountOccurrences(contents, "Discarded") == 0);
+
+		std::filesystem::remove(path);
+	}
+}
+
+int main()
+{
+	TestTraceFile();
+	TestRestart();
+
+	return TestUtil::Finish("HookTraceTests");
+}
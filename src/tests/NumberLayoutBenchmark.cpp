@@ -0,0 +1,130 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NumberLayout.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	template <typename Func>
+	double MeasureNanosecondsPerIteration(uint32_t iterations, Func&& func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			func(i);
+		}
+
+		const auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+	}
+
+	// A formatter that builds the grouped string with std::to_string and inserts, used as
+	// the baseline for the table based formatter.
+	std::string FormatWithToString(const NumberLayout& layout, int64_t number)
+	{
+		const bool negative = number < 0;
+		std::string digits = std::to_string(negative ? -number : number);
+
+		for (ptrdiff_t i = static_cast<ptrdiff_t>(digits.size()) - 3; i > 0; i -= 3)
+		{
+			digits.insert(static_cast<size_t>(i), layout.groupSeparator);
+		}
+
+		return (negative ? layout.negativePrefix : layout.positivePrefix)
+			+ digits
+			+ (negative ? layout.negativeSuffix : layout.positiveSuffix);
+	}
+
+	// The values cover 1 to 10 digits and both signs, as the query variables do.
+	std::vector<int64_t> MakeValues()
+	{
+		std::mt19937 random(1);
+		std::uniform_int_distribution<int32_t> digitCountDistribution(1, 10);
+		std::vector<int64_t> values(1024);
+
+		for (int64_t& value : values)
+		{
+			const int32_t digitCount = digitCountDistribution(random);
+			int64_t maximum = 1;
+
+			for (int32_t i = 0; i < digitCount; i++)
+			{
+				maximum *= 10;
+			}
+
+			value = std::uniform_int_distribution<int64_t>(-(maximum - 1), maximum - 1)(random) % 2147483647LL;
+		}
+
+		return values;
+	}
+
+	void BenchmarkLayout(const NumberLayout& layout, const char* description)
+	{
+		static constexpr uint32_t Iterations = 1000000;
+
+		const std::vector<int64_t> values = MakeValues();
+		char buffer[64];
+		volatile size_t sink = 0;
+
+		const double native = MeasureNanosecondsPerIteration(Iterations, [&](uint32_t i)
+		{
+			sink = sink + NumberLayoutFormatter::Format(layout, values[i % values.size()], buffer, sizeof(buffer));
+		});
+
+		const double baseline = MeasureNanosecondsPerIteration(Iterations, [&](uint32_t i)
+		{
+			sink = sink + FormatWithToString(layout, values[i % values.size()]).size();
+		});
+
+		std::printf("%s: NumberLayoutFormatter %.1f ns, std::to_string %.1f ns\n", description, native, baseline);
+	}
+
+	NumberLayout MakeLayout(const char* prefix, const char* negativePrefix, const char* suffix, const char* separator)
+	{
+		NumberLayout layout;
+		layout.positivePrefix = prefix;
+		layout.positiveSuffix = suffix;
+		layout.negativePrefix = negativePrefix;
+		layout.negativeSuffix = suffix;
+		layout.groupSeparator = separator;
+		layout.valid = true;
+
+		return layout;
+	}
+}
+
+int main()
+{
+	BenchmarkLayout(MakeLayout("", "-", "", ","), "Number, comma separator");
+	BenchmarkLayout(MakeLayout("\xC2\xA7", "-\xC2\xA7", "", ","), "Money, currency prefix");
+	BenchmarkLayout(MakeLayout("", "-", " \xC2\xA7", "\xC2\xA0"), "Money, currency suffix and no-break space");
+
+	return 0;
+}
@@ -0,0 +1,176 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NumberLayout.h"
+#include "TestUtil.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace
+{
+	// The UTF-8 encoding of the no-break space and section (Simolean) symbol.
+	constexpr std::string_view NoBreakSpace = "\xC2\xA0";
+	constexpr std::string_view Simolean = "\xC2\xA7";
+
+	NumberLayout MakeLayout(
+		std::string_view positivePrefix,
+		std::string_view positiveSuffix,
+		std::string_view negativePrefix,
+		std::string_view negativeSuffix,
+		std::string_view groupSeparator)
+	{
+		NumberLayout layout;
+		layout.positivePrefix = positivePrefix;
+		layout.positiveSuffix = positiveSuffix;
+		layout.negativePrefix = negativePrefix;
+		layout.negativeSuffix = negativeSuffix;
+		layout.groupSeparator = groupSeparator;
+		layout.valid = true;
+
+		return layout;
+	}
+
+	std::string Format(const NumberLayout& layout, int64_t number)
+	{
+		char buffer[64];
+
+		const size_t length = NumberLayoutFormatter::Format(layout, number, buffer, sizeof(buffer));
+
+		return std::string(buffer, length);
+	}
+
+	std::string Join(std::string_view a, std::string_view b, std::string_view c = {})
+	{
+		std::string result(a);
+		result.append(b);
+		result.append(c);
+
+		return result;
+	}
+
+	void TestCommaSeparator()
+	{
+		const NumberLayout layout = MakeLayout("", "", "-", "", ",");
+
+		TEST_CHECK(Format(layout, 0) == "0");
+		TEST_CHECK(Format(layout, 7) == "7");
+		TEST_CHECK(Format(layout, 42) == "42");
+		TEST_CHECK(Format(layout, 999) == "999");
+		TEST_CHECK(Format(layout, 1000) == "1,000");
+		TEST_CHECK(Format(layout, 12345) == "12,345");
+		TEST_CHECK(Format(layout, 999999) == "999,999");
+		TEST_CHECK(Format(layout, 1000000) == "1,000,000");
+		TEST_CHECK(Format(layout, 123456789) == "123,456,789");
+		TEST_CHECK(Format(layout, std::numeric_limits<int32_t>::max()) == "2,147,483,647");
+		TEST_CHECK(Format(layout, -7) == "-7");
+		TEST_CHECK(Format(layout, -1000) == "-1,000");
+		TEST_CHECK(Format(layout, -std::numeric_limits<int32_t>::max()) == "-2,147,483,647");
+	}
+
+	void TestPeriodSeparator()
+	{
+		const NumberLayout layout = MakeLayout("", "", "-", "", ".");
+
+		TEST_CHECK(Format(layout, 999) == "999");
+		TEST_CHECK(Format(layout, 1234567) == "1.234.567");
+		TEST_CHECK(Format(layout, -12345) == "-12.345");
+	}
+
+	void TestSpaceSeparators()
+	{
+		const NumberLayout space = MakeLayout("", "", "-", "", " ");
+
+		TEST_CHECK(Format(space, 1234567) == "1 234 567");
+		TEST_CHECK(Format(space, -1000) == "-1 000");
+
+		const NumberLayout noBreakSpace = MakeLayout("", "", "-", "", NoBreakSpace);
+
+		TEST_CHECK(Format(noBreakSpace, 999) == "999");
+		TEST_CHECK(Format(noBreakSpace, 1000) == Join("1", NoBreakSpace, "000"));
+		TEST_CHECK(Format(noBreakSpace, 1234567) == Join(Join("1", NoBreakSpace, "234"), NoBreakSpace, "567"));
+	}
+
+	void TestCurrencyPrefixAndSuffix()
+	{
+		const NumberLayout prefix = MakeLayout(Simolean, "", Join("-", Simolean), "", ",");
+
+		TEST_CHECK(Format(prefix, 0) == Join(Simolean, "0"));
+		TEST_CHECK(Format(prefix, 1234) == Join(Simolean, "1,234"));
+		TEST_CHECK(Format(prefix, -1234) == Join("-", Simolean, "1,234"));
+
+		const NumberLayout suffix = MakeLayout("", Join(" ", Simolean), "-", Join(" ", Simolean), ".");
+
+		TEST_CHECK(Format(suffix, 1234) == Join("1.234 ", Simolean));
+		TEST_CHECK(Format(suffix, -1234) == Join("-1.234 ", Simolean));
+	}
+
+	void TestNegativeForms()
+	{
+		const NumberLayout parentheses = MakeLayout(Simolean, "", Join("(", Simolean), ")", ",");
+
+		TEST_CHECK(Format(parentheses, 1000) == Join(Simolean, "1,000"));
+		TEST_CHECK(Format(parentheses, -1000) == Join("(", Simolean, "1,000)"));
+
+		const NumberLayout trailingMinus = MakeLayout("", "", "", "-", ",");
+
+		TEST_CHECK(Format(trailingMinus, 42) == "42");
+		TEST_CHECK(Format(trailingMinus, -42) == "42-");
+		TEST_CHECK(Format(trailingMinus, -123456) == "123,456-");
+	}
+
+	void TestInt64Range()
+	{
+		const NumberLayout layout = MakeLayout("", "", "-", "", ",");
+
+		TEST_CHECK(Format(layout, std::numeric_limits<int64_t>::max()) == "9,223,372,036,854,775,807");
+		TEST_CHECK(Format(layout, std::numeric_limits<int64_t>::min()) == "-9,223,372,036,854,775,808");
+	}
+
+	void TestBufferTooSmall()
+	{
+		const NumberLayout layout = MakeLayout(Simolean, "", Join("-", Simolean), "", ",");
+
+		char buffer[16];
+
+		// The formatted value is 11 bytes: the 2 byte prefix, 7 digits and 2 separators.
+		TEST_CHECK(NumberLayoutFormatter::Format(layout, 1234567, buffer, 11) == 11);
+		TEST_CHECK(std::string_view(buffer, 11) == Join(Simolean, "1,234,567"));
+		TEST_CHECK(NumberLayoutFormatter::Format(layout, 1234567, buffer, 10) == 0);
+		TEST_CHECK(NumberLayoutFormatter::Format(layout, -1234567, buffer, 11) == 0);
+		TEST_CHECK(NumberLayoutFormatter::Format(layout, 0, buffer, 0) == 0);
+	}
+}
+
+int main()
+{
+	TestCommaSeparator();
+	TestPeriodSeparator();
+	TestSpaceSeparators();
+	TestCurrencyPrefixAndSuffix();
+	TestNegativeForms();
+	TestInt64Range();
+	TestBufferTooSmall();
+
+	return TestUtil::Finish("NumberLayoutTests");
+}
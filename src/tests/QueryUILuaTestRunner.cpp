@@ -0,0 +1,935 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// A headless runner for the Lua query UI test scripts, it runs the functions that are listed
+// in the null45_query_ui_extensions_test_functions table with the stock Lua 5.0 interpreter.
+//
+// The null45_query_ui_extensions functions read the dialog occupant from a fixture that was
+// recorded in the game by null45_query_ui_extensions_test_record_fixture, see the fixtures folder.
+// The fixture also has the value that each test function returned in the game, a function
+// that returns a different value fails unless its test table entry has an expected value.
+//
+// Usage: QueryUILuaTestRunner <fixture> <script>...
+// The scripts are loaded in the order that they are specified, e.g. in package number order.
+
+// The Lua 5.0 headers do not declare the C linkage.
+extern "C"
+{
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+}
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace
+{
+	static constexpr const char* ExtensionTableName = "null45_query_ui_extensions";
+	static constexpr const char* TestFunctionTableName = "null45_query_ui_extensions_test_functions";
+	static constexpr const char* FixtureGlobalName = "null45_query_ui_extensions_fixture";
+
+	// The registry key of the metatable that is shared by every array view.
+	static constexpr const char* PropertyArrayViewMetaTableKey = "null45_query_ui_extensions.property_array_view";
+
+	// The hidden global that holds the occupant proxy table.
+	// Each fixture is run in its own Lua state, so the proxy never outlives its dialog.
+	static constexpr const char* OccupantProxyGlobalName = "__null45_query_ui_extensions_occupant";
+
+	// Limits the total time of the latency measurement for functions that are slow.
+	static constexpr uint32_t MaxIterations = 10000;
+
+	// Equivalents of the global functions that the game defines in its startup scripts.
+	static constexpr std::string_view GameGlobals =
+		"getn = table.getn\n"
+		"tinsert = table.insert\n"
+		"function hex2dec(hex_string) return tonumber(hex_string, 16) end\n";
+
+	struct TestSummary
+	{
+		uint32_t passed;
+		uint32_t failed;
+		uint32_t unchecked;
+
+		TestSummary() : passed(0), failed(0), unchecked(0)
+		{
+		}
+	};
+
+	// The userdata value of an array view, the elements are read from the fixture.
+	struct PropertyArrayView
+	{
+		uint32_t propertyID;
+	};
+
+	void GetGlobal(lua_State* pState, const char* name)
+	{
+		lua_pushstring(pState, name);
+		lua_gettable(pState, LUA_GLOBALSINDEX);
+	}
+
+	void SetGlobal(lua_State* pState, const char* name)
+	{
+		// The value is at the top of the stack.
+		lua_pushstring(pState, name);
+		lua_insert(pState, -2);
+		lua_settable(pState, LUA_GLOBALSINDEX);
+	}
+
+	// Pushes the specified field of the fixture table, or nil if it does not exist.
+	void PushFixtureField(lua_State* pState, const char* name)
+	{
+		GetGlobal(pState, FixtureGlobalName);
+
+		if (lua_istable(pState, -1))
+		{
+			lua_pushstring(pState, name);
+			lua_rawget(pState, -2);
+			lua_remove(pState, -2);
+		}
+		else
+		{
+			lua_pop(pState, 1);
+			lua_pushnil(pState);
+		}
+	}
+
+	// Pushes the specified entry of a fixture table, or nil if it does not exist.
+	// The key is at the top of the stack, it is replaced by the entry.
+	void GetFixtureTableEntry(lua_State* pState, const char* tableName)
+	{
+		PushFixtureField(pState, tableName);
+
+		if (lua_istable(pState, -1))
+		{
+			lua_insert(pState, -2);
+			lua_rawget(pState, -2);
+			lua_remove(pState, -2);
+		}
+		else
+		{
+			lua_pop(pState, 2);
+			lua_pushnil(pState);
+		}
+	}
+
+	bool ParseHexadecimalString(std::string_view text, uint32_t& value)
+	{
+		// The string must have an even number of characters, and may start with 0x.
+
+		if (text.empty() || (text.size() % 2) != 0)
+		{
+			return false;
+		}
+
+		if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+		{
+			text.remove_prefix(2);
+		}
+
+		if (text.size() > 8)
+		{
+			return false;
+		}
+
+		uint32_t result = 0;
+
+		for (char c : text)
+		{
+			uint32_t digit = 0;
+
+			if (c >= '0' && c <= '9')
+			{
+				digit = static_cast<uint32_t>(c - '0');
+			}
+			else if (c >= 'a' && c <= 'f')
+			{
+				digit = static_cast<uint32_t>(c - 'a' + 10);
+			}
+			else if (c >= 'A' && c <= 'F')
+			{
+				digit = static_cast<uint32_t>(c - 'A' + 10);
+			}
+			else
+			{
+				return false;
+			}
+
+			result = (result << 4) | digit;
+		}
+
+		value = result;
+		return true;
+	}
+
+	// Reads a property id parameter with the same rules as the DLL, a number in the uint32_t
+	// range or a hexadecimal string.
+	bool GetPropertyID(lua_State* pState, int index, uint32_t& propertyID)
+	{
+		if (lua_isnumber(pState, index))
+		{
+			const lua_Number number = lua_tonumber(pState, index);
+
+			if (number >= 0.0 && number <= static_cast<lua_Number>(UINT32_MAX))
+			{
+				propertyID = static_cast<uint32_t>(number);
+				return true;
+			}
+		}
+		else if (lua_isstring(pState, index))
+		{
+			return ParseHexadecimalString(
+				std::string_view(lua_tostring(pState, index), lua_strlen(pState, index)),
+				propertyID);
+		}
+
+		return false;
+	}
+
+	int GetArrayCount(lua_State* pState, int index)
+	{
+		int count = 0;
+
+		// Lua uses a one-based index for arrays.
+		for (;;)
+		{
+			lua_rawgeti(pState, index, count + 1);
+			const bool isNil = lua_isnil(pState, -1);
+			lua_pop(pState, 1);
+
+			if (isNil)
+			{
+				break;
+			}
+
+			count++;
+		}
+
+		return count;
+	}
+
+	// Pushes the recorded value of the specified property, or nil if the occupant does not have it.
+	void PushRecordedProperty(lua_State* pState, uint32_t propertyID)
+	{
+		lua_pushnumber(pState, static_cast<lua_Number>(propertyID));
+		GetFixtureTableEntry(pState, "properties");
+	}
+
+	// Pushes a recorded property value in the form that the DLL returns, arrays are
+	// copied into a new table and a single element array is returned as its element.
+	void PushPropertyValue(lua_State* pState, int index)
+	{
+		if (lua_istable(pState, index))
+		{
+			const int count = GetArrayCount(pState, index);
+
+			if (count == 1)
+			{
+				lua_rawgeti(pState, index, 1);
+			}
+			else
+			{
+				lua_newtable(pState);
+
+				for (int i = 1; i <= count; i++)
+				{
+					lua_rawgeti(pState, index, i);
+					lua_rawseti(pState, -2, i);
+				}
+			}
+		}
+		else
+		{
+			lua_pushvalue(pState, index);
+		}
+	}
+
+	// Determines if the value is a numeric or boolean array, string properties are
+	// recorded as Lua strings.
+	bool IsSupportedArrayType(lua_State* pState, int index)
+	{
+		if (!lua_istable(pState, index))
+		{
+			return false;
+		}
+
+		const int count = GetArrayCount(pState, index);
+
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(pState, index, i);
+			const int type = lua_type(pState, -1);
+			lua_pop(pState, 1);
+
+			if (type != LUA_TNUMBER && type != LUA_TBOOLEAN)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void PushTableCopy(lua_State* pState, int index)
+	{
+		lua_newtable(pState);
+		const int copy = lua_gettop(pState);
+
+		lua_pushnil(pState);
+
+		while (lua_next(pState, index) != 0)
+		{
+			// The key is at -2 and the value at -1, the key is kept for the next iteration.
+			lua_pushvalue(pState, -2);
+
+			if (lua_istable(pState, -2))
+			{
+				PushTableCopy(pState, lua_gettop(pState) - 1);
+			}
+			else
+			{
+				lua_pushvalue(pState, -2);
+			}
+
+			lua_rawset(pState, copy);
+			lua_pop(pState, 1);
+		}
+	}
+
+	int get_property_value(lua_State* pState)
+	{
+		uint32_t propertyID = 0;
+
+		if (lua_gettop(pState) == 1 && GetPropertyID(pState, 1, propertyID))
+		{
+			PushRecordedProperty(pState, propertyID);
+			PushPropertyValue(pState, lua_gettop(pState));
+		}
+		else
+		{
+			lua_pushnil(pState);
+		}
+
+		return 1;
+	}
+
+	int get_property_value_by_name(lua_State* pState)
+	{
+		if (lua_gettop(pState) == 1 && lua_type(pState, 1) == LUA_TSTRING)
+		{
+			lua_pushvalue(pState, 1);
+			GetFixtureTableEntry(pState, "properties_by_name");
+			PushPropertyValue(pState, lua_gettop(pState));
+		}
+		else
+		{
+			lua_pushnil(pState);
+		}
+
+		return 1;
+	}
+
+	int get_property_values(lua_State* pState)
+	{
+		if (lua_gettop(pState) == 1 && lua_istable(pState, 1))
+		{
+			// The result table is keyed by the property id, properties that do not
+			// exist are omitted from the table.
+			lua_newtable(pState);
+			const int result = lua_gettop(pState);
+
+			for (int i = 1; ; i++)
+			{
+				lua_rawgeti(pState, 1, i);
+
+				if (lua_isnil(pState, -1))
+				{
+					lua_pop(pState, 1);
+					break;
+				}
+
+				uint32_t propertyID = 0;
+				const bool validPropertyID = GetPropertyID(pState, -1, propertyID);
+				lua_pop(pState, 1);
+
+				if (validPropertyID)
+				{
+					PushRecordedProperty(pState, propertyID);
+					const int value = lua_gettop(pState);
+
+					if (!lua_isnil(pState, value))
+					{
+						lua_pushnumber(pState, static_cast<lua_Number>(propertyID));
+						PushPropertyValue(pState, value);
+						lua_rawset(pState, result);
+					}
+
+					lua_pop(pState, 1);
+				}
+			}
+		}
+		else
+		{
+			lua_pushnil(pState);
+		}
+
+		return 1;
+	}
+
+	int property_array_view_index(lua_State* pState)
+	{
+		// The __index metamethod is called with the view and the key.
+		const PropertyArrayView* pView = static_cast<const PropertyArrayView*>(lua_touserdata(pState, 1));
+
+		if (pView)
+		{
+			PushRecordedProperty(pState, pView->propertyID);
+			const int values = lua_gettop(pState);
+
+			if (!lua_istable(pState, values))
+			{
+				lua_pushnil(pState);
+			}
+			else if (lua_isnumber(pState, 2))
+			{
+				const lua_Number index = lua_tonumber(pState, 2);
+
+				// Lua uses a one-based index for arrays.
+				if (index >= 1.0 && index <= static_cast<lua_Number>(GetArrayCount(pState, values)))
+				{
+					lua_rawgeti(pState, values, static_cast<int>(index));
+				}
+				else
+				{
+					lua_pushnil(pState);
+				}
+			}
+			else if (lua_type(pState, 2) == LUA_TSTRING && std::string_view(lua_tostring(pState, 2), lua_strlen(pState, 2)) == "n")
+			{
+				lua_pushnumber(pState, static_cast<lua_Number>(GetArrayCount(pState, values)));
+			}
+			else
+			{
+				lua_pushnil(pState);
+			}
+		}
+		else
+		{
+			lua_pushnil(pState);
+		}
+
+		return 1;
+	}
+
+	void PushPropertyArrayViewMetaTable(lua_State* pState)
+	{
+		lua_pushstring(pState, PropertyArrayViewMetaTableKey);
+		lua_rawget(pState, LUA_REGISTRYINDEX);
+
+		if (lua_isnil(pState, -1))
+		{
+			lua_pop(pState, 1);
+
+			lua_newtable(pState);
+			lua_pushstring(pState, "__index");
+			lua_pushcfunction(pState, &property_array_view_index);
+			lua_rawset(pState, -3);
+
+			lua_pushstring(pState, PropertyArrayViewMetaTableKey);
+			lua_pushvalue(pState, -2);
+			lua_rawset(pState, LUA_REGISTRYINDEX);
+		}
+	}
+
+	int get_property_array_view(lua_State* pState)
+	{
+		uint32_t propertyID = 0;
+
+		if (lua_gettop(pState) == 1 && GetPropertyID(pState, 1, propertyID))
+		{
+			PushRecordedProperty(pState, propertyID);
+
+			if (IsSupportedArrayType(pState, lua_gettop(pState)))
+			{
+				void* pUserData = lua_newuserdata(pState, sizeof(PropertyArrayView));
+				static_cast<PropertyArrayView*>(pUserData)->propertyID = propertyID;
+
+				PushPropertyArrayViewMetaTable(pState);
+				lua_setmetatable(pState, -2);
+			}
+			else
+			{
+				lua_pushnil(pState);
+			}
+		}
+		else
+		{
+			lua_pushnil(pState);
+		}
+
+		return 1;
+	}
+
+	int occupant_proxy_index(lua_State* pState)
+	{
+		// The __index metamethod is called with the proxy and the key, it is only called
+		// for keys that are not already stored in the proxy.
+
+		if (lua_isnumber(pState, 2))
+		{
+			uint32_t propertyID = 0;
+
+			if (GetPropertyID(pState, 2, propertyID))
+			{
+				PushRecordedProperty(pState, propertyID);
+			}
+			else
+			{
+				lua_pushnil(pState);
+			}
+		}
+		else if (lua_type(pState, 2) == LUA_TSTRING)
+		{
+			lua_pushvalue(pState, 2);
+			GetFixtureTableEntry(pState, "properties_by_name");
+		}
+		else
+		{
+			lua_pushnil(pState);
+		}
+
+		if (!lua_isnil(pState, -1))
+		{
+			PushPropertyValue(pState, lua_gettop(pState));
+
+			// Store the converted value in the proxy, later reads of the same
+			// key will be plain table lookups that do not call this function.
+			lua_pushvalue(pState, 2);
+			lua_pushvalue(pState, -2);
+			lua_rawset(pState, 1);
+		}
+
+		return 1;
+	}
+
+	int occupant(lua_State* pState)
+	{
+		GetGlobal(pState, OccupantProxyGlobalName);
+
+		if (!lua_istable(pState, -1))
+		{
+			lua_pop(pState, 1);
+
+			lua_newtable(pState);
+
+			lua_newtable(pState);
+			lua_pushstring(pState, "__index");
+			lua_pushcfunction(pState, &occupant_proxy_index);
+			lua_rawset(pState, -3);
+			lua_setmetatable(pState, -2);
+
+			lua_pushvalue(pState, -1);
+			SetGlobal(pState, OccupantProxyGlobalName);
+		}
+
+		return 1;
+	}
+
+	int get_lot_stats(lua_State* pState)
+	{
+		PushFixtureField(pState, "lot_stats");
+
+		if (lua_istable(pState, -1))
+		{
+			// The DLL returns a new table for every call.
+			PushTableCopy(pState, lua_gettop(pState));
+		}
+		else
+		{
+			lua_pushnil(pState);
+		}
+
+		return 1;
+	}
+
+	struct LuaFunctionEntry
+	{
+		const char* name;
+		lua_CFunction function;
+	};
+
+	static constexpr LuaFunctionEntry LuaFunctions[] =
+	{
+		LuaFunctionEntry{ "get_property_value", &get_property_value },
+		LuaFunctionEntry{ "get_property_value_by_name", &get_property_value_by_name },
+		LuaFunctionEntry{ "get_property_values", &get_property_values },
+		LuaFunctionEntry{ "get_property_array_view", &get_property_array_view },
+		LuaFunctionEntry{ "occupant", &occupant },
+		LuaFunctionEntry{ "get_lot_stats", &get_lot_stats },
+	};
+
+	// Sets the functions in the null45_query_ui_extensions table, like the DLL does
+	// after the game has loaded the Lua scripts.
+	void RegisterExtensionFunctions(lua_State* pState)
+	{
+		GetGlobal(pState, ExtensionTableName);
+
+		if (!lua_istable(pState, -1))
+		{
+			lua_pop(pState, 1);
+			lua_newtable(pState);
+			lua_pushvalue(pState, -1);
+			SetGlobal(pState, ExtensionTableName);
+		}
+
+		for (const LuaFunctionEntry& entry : LuaFunctions)
+		{
+			lua_pushstring(pState, entry.name);
+			lua_pushcfunction(pState, entry.function);
+			lua_rawset(pState, -3);
+		}
+
+		lua_pop(pState, 1);
+	}
+
+	bool ReportStatus(lua_State* pState, int status, const char* name)
+	{
+		if (status != 0)
+		{
+			const char* errorString = lua_tostring(pState, -1);
+
+			std::printf("Error status code %d returned when loading %s, error text: %s.\n", status, name, errorString ? errorString : "");
+			lua_pop(pState, 1);
+		}
+
+		return status == 0;
+	}
+
+	bool RunScriptFile(lua_State* pState, const char* path)
+	{
+		int status = luaL_loadfile(pState, path);
+
+		if (status == 0)
+		{
+			status = lua_pcall(pState, 0, 0, 0);
+		}
+
+		return ReportStatus(pState, status, path);
+	}
+
+	bool RunScriptString(lua_State* pState, std::string_view script, const char* name)
+	{
+		int status = luaL_loadbuffer(pState, script.data(), script.size(), name);
+
+		if (status == 0)
+		{
+			status = lua_pcall(pState, 0, 0, 0);
+		}
+
+		return ReportStatus(pState, status, name);
+	}
+
+	bool CallTestFunction(lua_State* pState, const char* functionName, std::string& result)
+	{
+		bool succeeded = false;
+
+		const int top = lua_gettop(pState);
+
+		GetGlobal(pState, functionName);
+
+		if (lua_isfunction(pState, -1))
+		{
+			// The test functions take no parameters and return a string.
+
+			const int status = lua_pcall(pState, 0, 1, 0);
+
+			if (status == 0)
+			{
+				if (lua_isstring(pState, -1))
+				{
+					result.assign(lua_tostring(pState, -1), lua_strlen(pState, -1));
+					succeeded = true;
+				}
+				else
+				{
+					std::printf("%s() did not return a string.\n", functionName);
+				}
+			}
+			else
+			{
+				const char* errorString = lua_tostring(pState, -1);
+
+				std::printf(
+					"Error status code %d returned when calling %s(), error text: %s.\n",
+					status,
+					functionName,
+					errorString ? errorString : "");
+			}
+		}
+		else if (lua_isnil(pState, -1))
+		{
+			std::printf("%s() does not exist.\n", functionName);
+		}
+		else
+		{
+			std::printf("%s is not a function, actual type: %s.\n", functionName, lua_typename(pState, lua_type(pState, -1)));
+		}
+
+		lua_settop(pState, top);
+
+		return succeeded;
+	}
+
+	bool GetStringField(lua_State* pState, int table, const char* name, std::string& value)
+	{
+		bool result = false;
+
+		lua_pushstring(pState, name);
+		lua_rawget(pState, table);
+
+		if (lua_type(pState, -1) == LUA_TSTRING)
+		{
+			value.assign(lua_tostring(pState, -1), lua_strlen(pState, -1));
+			result = true;
+		}
+
+		lua_pop(pState, 1);
+
+		return result;
+	}
+
+	uint32_t GetIterationsField(lua_State* pState, int table)
+	{
+		uint32_t iterations = 1;
+
+		lua_pushstring(pState, "iterations");
+		lua_rawget(pState, table);
+
+		if (lua_type(pState, -1) == LUA_TNUMBER)
+		{
+			const lua_Number value = lua_tonumber(pState, -1);
+
+			if (value >= 1.0)
+			{
+				iterations = value < static_cast<lua_Number>(MaxIterations) ? static_cast<uint32_t>(value) : MaxIterations;
+			}
+		}
+
+		lua_pop(pState, 1);
+
+		return iterations;
+	}
+
+	// Gets the value that the function returned when the fixture was recorded.
+	bool GetRecordedResult(lua_State* pState, const std::string& functionName, std::string& value)
+	{
+		bool result = false;
+
+		lua_pushlstring(pState, functionName.data(), functionName.size());
+		GetFixtureTableEntry(pState, "results");
+
+		if (lua_type(pState, -1) == LUA_TSTRING)
+		{
+			value.assign(lua_tostring(pState, -1), lua_strlen(pState, -1));
+			result = true;
+		}
+
+		lua_pop(pState, 1);
+
+		return result;
+	}
+
+	void RunTestFunction(
+		lua_State* pState,
+		const std::string& functionName,
+		const std::string* pExpected,
+		uint32_t iterations,
+		TestSummary& summary)
+	{
+		std::string result;
+
+		if (!CallTestFunction(pState, functionName.c_str(), result))
+		{
+			summary.failed++;
+			return;
+		}
+
+		if (pExpected)
+		{
+			if (result == *pExpected)
+			{
+				summary.passed++;
+				std::printf("PASS %s() returned: %s\n", functionName.c_str(), result.c_str());
+			}
+			else
+			{
+				summary.failed++;
+				std::printf(
+					"FAIL %s() returned: %s, expected: %s\n",
+					functionName.c_str(),
+					result.c_str(),
+					pExpected->c_str());
+			}
+		}
+		else
+		{
+			summary.unchecked++;
+			std::printf("%s() returned: %s\n", functionName.c_str(), result.c_str());
+		}
+
+		// The first call is excluded from the latency measurement, it may include
+		// one-time costs such as building the occupant proxy.
+
+		const auto start = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			CallTestFunction(pState, functionName.c_str(), result);
+		}
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start);
+
+		std::printf(
+			"%s() latency: %.3f us per call (%u calls).\n",
+			functionName.c_str(),
+			static_cast<double>(elapsed.count()) / 1000.0 / static_cast<double>(iterations),
+			iterations);
+	}
+
+	bool RunLuaScriptTests(lua_State* pState)
+	{
+		const int top = lua_gettop(pState);
+
+		GetGlobal(pState, TestFunctionTableName);
+
+		if (!lua_istable(pState, -1))
+		{
+			std::printf("%s does not exist.\n", TestFunctionTableName);
+			lua_settop(pState, top);
+			return false;
+		}
+
+		const int table = lua_gettop(pState);
+		TestSummary summary;
+
+		// Lua uses a one-based index for arrays.
+		for (int i = 1; ; i++)
+		{
+			lua_rawgeti(pState, table, i);
+
+			if (!lua_istable(pState, -1))
+			{
+				break;
+			}
+
+			const int entry = lua_gettop(pState);
+			std::string name;
+
+			if (GetStringField(pState, entry, "name", name))
+			{
+				// The expected value of the test table entry takes precedence over the recorded value.
+				std::string expected;
+				const bool hasExpected = GetStringField(pState, entry, "expected", expected)
+					|| GetRecordedResult(pState, name, expected);
+
+				RunTestFunction(
+					pState,
+					name,
+					hasExpected ? &expected : nullptr,
+					GetIterationsField(pState, entry),
+					summary);
+			}
+
+			lua_pop(pState, 1);
+		}
+
+		lua_settop(pState, top);
+
+		std::printf(
+			"Lua query UI tests: %u passed, %u failed, %u without an expected value.\n",
+			summary.passed,
+			summary.failed,
+			summary.unchecked);
+
+		return summary.failed == 0;
+	}
+
+	void OpenLibraries(lua_State* pState)
+	{
+		// The Lua 5.0 library functions leave their tables on the stack.
+		luaopen_base(pState);
+		lua_settop(pState, 0);
+		luaopen_table(pState);
+		lua_settop(pState, 0);
+		luaopen_string(pState);
+		lua_settop(pState, 0);
+		luaopen_math(pState);
+		lua_settop(pState, 0);
+	}
+
+	bool Run(const char* fixturePath, const char* const* scriptPaths, int scriptCount)
+	{
+		lua_State* pState = lua_open();
+
+		if (!pState)
+		{
+			std::printf("Failed to create the Lua state.\n");
+			return false;
+		}
+
+		OpenLibraries(pState);
+
+		bool succeeded = RunScriptString(pState, GameGlobals, "game globals");
+
+		for (int i = 0; succeeded && i < scriptCount; i++)
+		{
+			succeeded = RunScriptFile(pState, scriptPaths[i]);
+		}
+
+		if (succeeded)
+		{
+			RegisterExtensionFunctions(pState);
+
+			succeeded = RunScriptFile(pState, fixturePath) && RunLuaScriptTests(pState);
+		}
+
+		lua_close(pState);
+
+		return succeeded;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::printf("Usage: QueryUILuaTestRunner <fixture> <script>...\n");
+		return 2;
+	}
+
+	std::printf("Fixture: %s\n", argv[1]);
+
+	return Run(argv[1], argv + 2, argc - 2) ? 0 : 1;
+}
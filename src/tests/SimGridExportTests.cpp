@@ -0,0 +1,310 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SimGridExportReader.h"
+#include "SimGridExportWriter.h"
+#include "TestUtil.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+	// The grid is not square and its row size is not a multiple of 4, so swapped
+	// coordinates or a wrong row stride change the values that are read back.
+	static constexpr uint32_t CellCountX = 17;
+	static constexpr uint32_t CellCountZ = 5;
+
+	uint8_t GetUInt8Value(uint32_t x, uint32_t z)
+	{
+		return static_cast<uint8_t>((x * 7) + (z * 31));
+	}
+
+	int8_t GetInt8Value(uint32_t x, uint32_t z)
+	{
+		return static_cast<int8_t>(static_cast<int32_t>(x) - static_cast<int32_t>(z * 20));
+	}
+
+	int32_t GetInt32Value(uint32_t x, uint32_t z)
+	{
+		return (static_cast<int32_t>(x) * 100000) - (static_cast<int32_t>(z) * 7);
+	}
+
+	float GetFloatValue(uint32_t x, uint32_t z)
+	{
+		return (static_cast<float>(x) * 0.25f) - static_cast<float>(z);
+	}
+
+	std::filesystem::path GetTestFilePath()
+	{
+		return std::filesystem::temp_directory_path() / "SimGridExportTests.bin";
+	}
+
+	bool WriteTestFile(const std::filesystem::path& path)
+	{
+		SimGridExportWriter writer(CellCountX, CellCountZ);
+
+		writer.AddColumn(
+			"uint8",
+			SimGridExportValueType::UInt8,
+			[](uint32_t z, void* values)
+			{
+				for (uint32_t x = 0; x < CellCountX; x++)
+				{
+					static_cast<uint8_t*>(values)[x] = GetUInt8Value(x, z);
+				}
+			});
+		writer.AddColumn(
+			"int8",
+			SimGridExportValueType::Int8,
+			[](uint32_t z, void* values)
+			{
+				for (uint32_t x = 0; x < CellCountX; x++)
+				{
+					static_cast<int8_t*>(values)[x] = GetInt8Value(x, z);
+				}
+			});
+		writer.AddColumn(
+			"int32",
+			SimGridExportValueType::Int32,
+			[](uint32_t z, void* values)
+			{
+				for (uint32_t x = 0; x < CellCountX; x++)
+				{
+					static_cast<int32_t*>(values)[x] = GetInt32Value(x, z);
+				}
+			});
+		writer.AddColumn(
+			"float32",
+			SimGridExportValueType::Float32,
+			[](uint32_t z, void* values)
+			{
+				for (uint32_t x = 0; x < CellCountX; x++)
+				{
+					static_cast<float*>(values)[x] = GetFloatValue(x, z);
+				}
+			});
+		// The name is longer than the column name field, it is truncated.
+		writer.AddColumn(
+			"a_column_name_that_is_longer_than_31_characters",
+			SimGridExportValueType::UInt8,
+			[](uint32_t z, void* values)
+			{
+				std::memset(values, static_cast<int>(z), CellCountX);
+			});
+
+		return writer.Write(path);
+	}
+
+	std::vector<uint8_t> ReadFile(const std::filesystem::path& path)
+	{
+		std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	template <typename T, typename TExpected>
+	void CheckColumnValues(const SimGridExportReader& reader, const char* name, TExpected getExpected)
+	{
+		const SimGridExportColumn* pColumn = reader.FindColumn(name);
+
+		TEST_CHECK(pColumn != nullptr);
+
+		if (pColumn)
+		{
+			TEST_CHECK(pColumn->offset % SimGridExportPageSize == 0);
+			TEST_CHECK(pColumn->size == static_cast<uint64_t>(CellCountX) * CellCountZ * sizeof(T));
+
+			const T* values = reader.GetColumnValues<T>(*pColumn);
+
+			TEST_CHECK(values != nullptr);
+
+			if (values)
+			{
+				bool allMatch = true;
+
+				for (uint32_t z = 0; z < CellCountZ; z++)
+				{
+					for (uint32_t x = 0; x < CellCountX; x++)
+					{
+						if (values[(z * CellCountX) + x] != getExpected(x, z))
+						{
+							allMatch = false;
+						}
+					}
+				}
+
+				TEST_CHECK(allMatch);
+			}
+		}
+	}
+
+	void CheckReader(const SimGridExportReader& reader)
+	{
+		const SimGridExportHeader& header = reader.GetHeader();
+
+		TEST_CHECK(header.cellCountX == CellCountX);
+		TEST_CHECK(header.cellCountZ == CellCountZ);
+		TEST_CHECK(header.pageSize == SimGridExportPageSize);
+		TEST_CHECK(reader.GetColumnCount() == 5);
+
+		CheckColumnValues<uint8_t>(reader, "uint8", &GetUInt8Value);
+		CheckColumnValues<int8_t>(reader, "int8", &GetInt8Value);
+		CheckColumnValues<int32_t>(reader, "int32", &GetInt32Value);
+		CheckColumnValues<float>(reader, "float32", &GetFloatValue);
+		CheckColumnValues<uint8_t>(reader, "a_column_name_that_is_longer_th", [](uint32_t, uint32_t z) { return static_cast<uint8_t>(z); });
+
+		TEST_CHECK(reader.FindColumn("missing") == nullptr);
+		TEST_CHECK(reader.FindColumn("uint") == nullptr);
+
+		const SimGridExportColumn* pInt32Column = reader.FindColumn("int32");
+
+		if (pInt32Column)
+		{
+			// The value type size must match the column value size.
+			TEST_CHECK(reader.GetColumnValues<uint8_t>(*pInt32Column) == nullptr);
+		}
+	}
+
+	void TestRoundTrip(const std::vector<uint8_t>& file)
+	{
+		TEST_CHECK(file.size() % SimGridExportPageSize == 0);
+
+		SimGridExportReader reader;
+
+		TEST_CHECK(reader.Attach(file.data(), file.size()));
+		CheckReader(reader);
+	}
+
+#ifdef SIM_GRID_EXPORT_READER_HAS_MMAP
+	void TestOpen(const std::filesystem::path& path)
+	{
+		SimGridExportReader reader;
+
+		TEST_CHECK(reader.Open(path.string().c_str()));
+		CheckReader(reader);
+
+		TEST_CHECK(!reader.Open((path.string() + ".missing").c_str()));
+	}
+#endif // SIM_GRID_EXPORT_READER_HAS_MMAP
+
+	SimGridExportHeader& GetHeader(std::vector<uint8_t>& file)
+	{
+		return *reinterpret_cast<SimGridExportHeader*>(file.data());
+	}
+
+	SimGridExportColumn& GetColumn(std::vector<uint8_t>& file, uint32_t index)
+	{
+		return reinterpret_cast<SimGridExportColumn*>(file.data() + GetHeader(file).columnTableOffset)[index];
+	}
+
+	template <typename TModify>
+	bool AttachModified(const std::vector<uint8_t>& file, TModify modify)
+	{
+		std::vector<uint8_t> copy = file;
+		modify(copy);
+
+		SimGridExportReader reader;
+
+		return reader.Attach(copy.data(), copy.size());
+	}
+
+	void TestValidation(const std::vector<uint8_t>& file)
+	{
+		SimGridExportReader reader;
+
+		TEST_CHECK(!reader.Attach(nullptr, file.size()));
+		TEST_CHECK(!reader.Attach(file.data(), sizeof(SimGridExportHeader) - 1));
+		// The header file size does not match a truncated file.
+		TEST_CHECK(!reader.Attach(file.data(), file.size() - SimGridExportPageSize));
+
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).magic[0] = 'X'; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).version = SimGridExportVersion + 1; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).headerSize = 0; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).pageSize = 0; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).fileSize += 1; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).columnTableOffset += 1; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).columnTableOffset = f.size() + 8; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).columnCount = 0xFFFFFFFF; }));
+		// A city size that does not match the column sizes.
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetHeader(f).cellCountX += 1; }));
+
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetColumn(f, 0).valueType = static_cast<SimGridExportValueType>(4); }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetColumn(f, 2).valueSize = 1; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetColumn(f, 1).offset += 1; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetColumn(f, 3).size -= 4; }));
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetColumn(f, 4).offset = f.size(); }));
+		// A column offset that would overflow when its size is added.
+		TEST_CHECK(!AttachModified(file, [](std::vector<uint8_t>& f) { GetColumn(f, 4).offset = ~static_cast<uint64_t>(SimGridExportPageSize - 1); }));
+
+		// The unmodified file is still accepted.
+		TEST_CHECK(AttachModified(file, [](std::vector<uint8_t>&) {}));
+	}
+
+	void TestEmptyColumnList()
+	{
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / "SimGridExportTests.Empty.bin";
+
+		SimGridExportWriter writer(CellCountX, CellCountZ);
+
+		TEST_CHECK(writer.Write(path));
+
+		const std::vector<uint8_t> file = ReadFile(path);
+		SimGridExportReader reader;
+
+		TEST_CHECK(reader.Attach(file.data(), file.size()));
+		TEST_CHECK(file.size() == SimGridExportPageSize);
+		TEST_CHECK(reader.GetColumnCount() == 0);
+
+		std::filesystem::remove(path);
+	}
+}
+
+int main()
+{
+	const std::filesystem::path path = GetTestFilePath();
+
+	TEST_CHECK(WriteTestFile(path));
+
+	const std::vector<uint8_t> file = ReadFile(path);
+
+	TEST_CHECK(file.size() >= sizeof(SimGridExportHeader));
+
+	if (file.size() >= sizeof(SimGridExportHeader))
+	{
+		TestRoundTrip(file);
+		TestValidation(file);
+	}
+
+#ifdef SIM_GRID_EXPORT_READER_HAS_MMAP
+	TestOpen(path);
+#endif // SIM_GRID_EXPORT_READER_HAS_MMAP
+
+	TestEmptyColumnList();
+
+	std::filesystem::remove(path);
+
+	return TestUtil::Finish("SimGridExportTests");
+}
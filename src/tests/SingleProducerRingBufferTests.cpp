@@ -0,0 +1,119 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SingleProducerRingBuffer.h"
+#include "TestUtil.h"
+
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+	void TestEmptyAndFull()
+	{
+		SingleProducerRingBuffer<int32_t, 8> buffer;
+		int32_t item = 0;
+
+		TEST_CHECK(!buffer.TryPop(item));
+
+		for (int32_t i = 0; i < 8; i++)
+		{
+			TEST_CHECK(buffer.TryPush(i));
+		}
+
+		// The buffer is full, the item is dropped.
+		TEST_CHECK(!buffer.TryPush(8));
+
+		for (int32_t i = 0; i < 8; i++)
+		{
+			TEST_CHECK(buffer.TryPop(item));
+			TEST_CHECK(item == i);
+		}
+
+		TEST_CHECK(!buffer.TryPop(item));
+	}
+
+	void TestWrapAround()
+	{
+		SingleProducerRingBuffer<int32_t, 4> buffer;
+		int32_t item = 0;
+
+		// The indices wrap around the buffer many times.
+		for (int32_t i = 0; i < 1000; i++)
+		{
+			TEST_CHECK(buffer.TryPush(i));
+			TEST_CHECK(buffer.TryPush(i + 1));
+			TEST_CHECK(buffer.TryPop(item));
+			TEST_CHECK(item == i);
+			TEST_CHECK(buffer.TryPop(item));
+			TEST_CHECK(item == i + 1);
+		}
+
+		TEST_CHECK(!buffer.TryPop(item));
+	}
+
+	void TestConcurrentProducerAndConsumer()
+	{
+		static constexpr uint64_t ItemCount = 200000;
+		static SingleProducerRingBuffer<uint64_t, 1024> buffer;
+
+		uint64_t consumedSum = 0;
+		bool inOrder = true;
+
+		std::thread consumer([&]()
+		{
+			uint64_t expected = 0;
+			uint64_t item = 0;
+
+			while (expected < ItemCount)
+			{
+				if (buffer.TryPop(item))
+				{
+					inOrder = inOrder && item == expected;
+					consumedSum += item;
+					expected++;
+				}
+			}
+		});
+
+		for (uint64_t i = 0; i < ItemCount;)
+		{
+			if (buffer.TryPush(i))
+			{
+				i++;
+			}
+		}
+
+		consumer.join();
+
+		TEST_CHECK(inOrder);
+		TEST_CHECK(consumedSum == ItemCount * (ItemCount - 1) / 2);
+	}
+}
+
+int main()
+{
+	TestEmptyAndFull();
+	TestWrapAround();
+	TestConcurrentProducerAndConsumer();
+
+	return TestUtil::Finish("SingleProducerRingBufferTests");
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of sc4-query-ui-hooks, a DLL Plugin for SimCity 4 that
+ * extends the query UI.
+ *
+ * Copyright (C) 2026 Nicholas Hayes
+ *
+ * sc4-query-ui-hooks is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-query-ui-hooks is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-query-ui-hooks.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdio>
+
+// A minimal check macro for the host tests, a failed check is reported and the
+// test continues so that all of the failures are listed.
+namespace TestUtil
+{
+	inline int& FailureCount()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline void ReportFailure(const char* expression, const char* file, int line)
+	{
+		std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+		FailureCount()++;
+	}
+
+	// Returns the process exit code of the test.
+	inline int Finish(const char* testName)
+	{
+		const int failures = FailureCount();
+
+		if (failures == 0)
+		{
+			std::printf("%s: passed\n", testName);
+			return 0;
+		}
+
+		std::printf("%s: %d check(s) failed\n", testName, failures);
+		return 1;
+	}
+}
+
+#define TEST_CHECK(expression) \
+	do \
+	{ \
+		if (!(expression)) \
+		{ \
+			TestUtil::ReportFailure(#expression, __FILE__, __LINE__); \
+		} \
+	} while (0)
@@ -0,0 +1,49 @@
+-- A hand-written sample fixture in the format that null45_query_ui_extensions_test_record_fixture
+-- writes, it describes a growable 1x1 low wealth residential building.
+-- Fixtures that are recorded in the game are written to SC4QueryUIHooks.LuaTestFixture.lua
+-- by the debug build of the DLL when RecordLuaTestFixture is enabled in SC4QueryUIHooks.ini.
+null45_query_ui_extensions_fixture =
+{
+  properties =
+  {
+    [hex2dec('00000010')] = 2,
+    [hex2dec('00000020')] = "R$1_1x1_Sample_House",
+    [hex2dec('099afacd')] = 250,
+    [hex2dec('27812810')] = { 12.5, 10, 14, },
+    [hex2dec('27812832')] = 1,
+    [hex2dec('27812833')] = 1,
+    [hex2dec('27812834')] = { 4112, 14, },
+    [hex2dec('27812840')] = { 40, },
+    [hex2dec('27812851')] = { 2, 0, 3, 0, },
+    [hex2dec('27812854')] = 5,
+    [hex2dec('2a499f85')] = 2720335104,
+  },
+  properties_by_name =
+  {
+    ["Exemplar Name"] = "R$1_1x1_Sample_House",
+    ["Bulldoze Cost"] = 250,
+  },
+  lot_stats =
+  {
+    population = { r1 = 8, r2 = 0, r3 = 0, cs1 = 0, cs2 = 0, cs3 = 0, co2 = 0, co3 = 0, ir = 0, id = 0, im = 0, iht = 0, },
+    capacity = { r1 = 14, r2 = 0, r3 = 0, cs1 = 0, cs2 = 0, cs3 = 0, co2 = 0, co3 = 0, ir = 0, id = 0, im = 0, iht = 0, },
+    jobs = { 0, 0, 0, },
+    travel_jobs = { 6, 0, 0, },
+    plopped = false,
+    growth_stage = 1,
+  },
+  results =
+  {
+    ["null45_query_ui_extensions_test_get_exemplar_name"] = "R$1_1x1_Sample_House",
+    ["null45_query_ui_extensions_test_get_bulldoze_cost"] = "250",
+    ["null45_query_ui_extensions_test_get_bulldoze_cost_by_name"] = "250",
+    ["null45_query_ui_extensions_test_get_garbage_pollution_at_center"] = "3",
+    ["null45_query_ui_extensions_test_get_garbage_pollution_at_center_view"] = "3",
+    ["null45_query_ui_extensions_test_get_property_values"] = "R$1_1x1_Sample_House, 250",
+    ["null45_query_ui_extensions_test_occupant_proxy"] = "R$1_1x1_Sample_House, 250",
+    ["null45_query_ui_extensions_test_get_lot_stats"] = "Residents: 8, Jobs: 0, Stage: 1",
+    ["null45_query_ui_extensions_test_property_read_consistency"] = "ok",
+    ["null45_query_ui_extensions_test_benchmark_single"] = "11000 values read",
+    ["null45_query_ui_extensions_test_benchmark_batched"] = "11000 values read",
+  },
+}